@@ -16,26 +16,55 @@
  * 
  * DATA FLOW:
  * INPUTS:
- *   - C++ source file path (command-line argument)
+ *   - C++ source file path (command-line argument; with --stdin its unsaved
+ *     contents are read from stdin), or framed requests on
+ *     stdin in --serve mode, or a compilation database / file list in --batch mode
  *   - Compiler arguments (optional, after -- separator)
  *   - Clang/LLVM libraries (libclang, libLLVM)
  * 
  * PROCESSING:
- *   1. Reads C++ source file from filesystem
- *   2. Uses clang::tooling::buildASTFromCodeWithArgs() to build AST
- *   3. Traverses AST using RecursiveASTVisitor
- *   4. For each function with body:
+ *   1. Reads C++ source file from filesystem, or maps unsaved contents over
+ *      its path in memory
+ *   2. Adds the toolchain's system include directories, found through the
+ *      clang Driver API and cached on disk (see getSystemIncludeArgs)
+ *   3. Uses clang::tooling::ToolInvocation to build the AST (one invocation per
+ *      file; --serve keeps the process and its system header stat cache alive)
+ *   4. Traverses AST using RecursiveASTVisitor
+ *   5. For each function with body:
  *      - Uses clang::CFG::buildCFG() to generate official Clang CFG
  *      - Extracts blocks, statements, predecessors, successors
  *      - Converts to JSON format
  * 
  * OUTPUTS:
  *   - JSON output to stdout containing:
- *     - Function metadata (name, file, range)
+ *     - Function metadata (name, USR, record hash, file, range, signature)
  *     - CFG blocks with:
  *       - Block ID, label, entry/exit flags
- *       - Statements (text, range)
- *       - Predecessors and successors (control flow edges)
+ *       - Statements (element ID, text, range, DEF/USE variable IDs and
+ *         field/index/deref access paths); with --top-level-statements one
+ *         per source-level statement
+ *       - Call sites (callee name and USR, argument DEF/USE, return use;
+ *         with --taint-spec their source/sink/sanitizer roles)
+ *       - Terminator kind, branch condition, its uses and constant value,
+ *         true/false successors
+ *       - Predecessors and successors (control flow edges), and the successors
+ *         of constant branches that can never be taken
+ *       - Immediate dominator and post-dominator, control dependences
+ *       - Reverse-postorder and postorder index, back edges, innermost loop
+ *         header and loop depth
+ *     - With --simplify-cfg, unreachable and empty blocks removed and
+ *       straight-line chains fused (original block IDs in mergedBlocks)
+ *     - Per-function variable table (ID -> name, kind) and the globals each
+ *       function reads and writes directly
+ *     - Per-file table of variables with static storage duration
+ *   - With --batch --header-functions, functions defined in project headers
+ *     too, each exported by the first translation unit that reaches it
+ *     (marked "header": true, file is the header)
+ *   - With --stream, one compact JSON line per function (NDJSON), written as
+ *     soon as that function's CFG is exported
+ *   - With --format=msgpack|cbor, the same values in a binary encoding
+ *   - With --intern-strings, paths, texts, names and types as indices into a
+ *     string table each record extends ("strings")
  *   - JSON output -> ClangASTParser.ts (via stdout/stdin)
  * 
  * DEPENDENCIES:
@@ -44,6 +73,10 @@
  * 
  * USAGE:
  *   ./cfg-exporter <source-file> -- -std=c++17 -Iinclude
+ *   ./cfg-exporter --stream <source-file> -- -std=c++17 -Iinclude
+ *   ./cfg-exporter --function=ns::parse --lines=40-80 <source-file>
+ *   ./cfg-exporter --serve -- -std=c++17 -Iinclude
+ *   ./cfg-exporter --batch -p build -j 8
  * 
  * ACADEMIC CORRECTNESS:
  * Uses official clang::CFG::buildCFG() from libclang/LLVM, ensuring that generated
@@ -52,214 +85,3027 @@
  */
 
 #include <clang/AST/ASTContext.h>
+#include <clang/AST/ParentMap.h>
 #include <clang/AST/RecursiveASTVisitor.h>
 #include <clang/Basic/SourceManager.h>
+#include <clang/Basic/Version.h>
+#include <clang/Driver/Compilation.h>
+#include <clang/Driver/Driver.h>
+#include <clang/Driver/Job.h>
+#include <clang/Frontend/ASTUnit.h>
 #include <clang/Frontend/CompilerInstance.h>
 #include <clang/Frontend/FrontendActions.h>
+#include <clang/Index/USRGeneration.h>
+#include <clang/Lex/Lexer.h>
+#include <clang/Lex/MacroInfo.h>
+#include <clang/Lex/Preprocessor.h>
+#include <clang/Tooling/ArgumentsAdjusters.h>
+#include <clang/Tooling/CompilationDatabase.h>
+#include <clang/Tooling/JSONCompilationDatabase.h>
 #include <clang/Tooling/Tooling.h>
+#include <clang/Analysis/Analyses/Dominators.h>
 #include <clang/Analysis/CFG.h>
+#include <llvm/ADT/StringMap.h>
+#include <llvm/Config/llvm-config.h>
 #include <llvm/Support/CommandLine.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MD5.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/Process.h>
+#include <llvm/Support/Program.h>
+#include <llvm/Support/VirtualFileSystem.h>
 #include <llvm/Support/raw_ostream.h>
+#include <llvm/TargetParser/Host.h>
 #include <nlohmann/json.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <list>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
 #include <string>
+#include <thread>
 #include <vector>
 #include <fstream>
 
+// Written against the LLVM 18 API: CompilerInstance::createDiagnostics, the
+// clang Driver and ASTUnit::LoadFromCommandLine change signatures between
+// major releases, and llvm/TargetParser/Host.h first appeared in LLVM 17
+#if LLVM_VERSION_MAJOR != 18
+#error "cfg-exporter requires LLVM/Clang 18 (see CMakeLists.txt)"
+#endif
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
 using namespace clang;
 using namespace clang::tooling;
 using json = nlohmann::json;
 
-class CFGExporterVisitor : public RecursiveASTVisitor<CFGExporterVisitor> {
-public:
-  explicit CFGExporterVisitor(ASTContext &Context) : Context(Context) {}
+/**
+ * Taint roles of known functions, loaded from a registry spec (--taint-spec)
+ * exported by the extension's source, sink and sanitizer registries:
+ *
+ *   { "sources":    [ { "name": "fgets", "category": "file_io", "argumentIndex": 0 } ],
+ *     "sinks":      [ { "name": "system", "category": "command", "argumentIndices": [ 0 ] } ],
+ *     "sanitizers": [ { "name": "atoi", "type": "conversion", "inputIndex": 0, "outputIndex": -1 } ] }
+ *
+ * Names are matched exactly (qualified name first, then plain name), so each
+ * call costs one hash lookup; registry regex patterns are not used.
+ */
+class TaintSpec {
+public:
+  /// Argument index of Entry::Target meaning the call's return value.
+  static constexpr int ReturnValue = -1;
+  /// Entry::Target of sinks, which taint nothing.
+  static constexpr int NoTarget = -2;
+
+  struct Entry {
+    std::string Role;            ///< "source", "sink" or "sanitizer"
+    std::string Name;            ///< Registry entry name
+    std::string Category;        ///< Source/sink category or sanitization type
+    std::vector<int> Arguments;  ///< Tainted (source, sink) or sanitized argument indices
+    int Target = NoTarget;       ///< Argument receiving the taint/sanitized value, or ReturnValue
+  };
+
+  /// Load the spec at Path; null with Error set if it cannot be read.
+  static std::shared_ptr<const TaintSpec> load(const std::string &Path, std::string &Error) {
+    std::ifstream Input(Path);
+    if (!Input) {
+      Error = "Cannot read taint spec " + Path;
+      return nullptr;
+    }
+    json Spec = json::parse(Input, nullptr, /*allow_exceptions=*/false);
+    if (Spec.is_discarded() || !Spec.is_object()) {
+      Error = "Malformed taint spec " + Path;
+      return nullptr;
+    }
+
+    auto Result = std::make_shared<TaintSpec>();
+    for (const json &Source : Spec.value("sources", json::array())) {
+      int Index = Source.value("argumentIndex", ReturnValue);
+      Result->add({"source", Source.value("name", ""), Source.value("category", ""),
+                   Index >= 0 ? std::vector<int>{Index} : std::vector<int>{}, Index >= 0 ? Index : ReturnValue});
+    }
+    for (const json &Sink : Spec.value("sinks", json::array())) {
+      Result->add({"sink", Sink.value("name", ""), Sink.value("category", ""),
+                   Sink.value("argumentIndices", std::vector<int>{}), NoTarget});
+    }
+    for (const json &Sanitizer : Spec.value("sanitizers", json::array())) {
+      int Output = Sanitizer.value("outputIndex", ReturnValue);
+      Result->add({"sanitizer", Sanitizer.value("name", ""), Sanitizer.value("type", ""),
+                   {Sanitizer.value("inputIndex", 0)}, Output >= 0 ? Output : ReturnValue});
+    }
+    return Result;
+  }
+
+  /// Entries for a callee, or null if it plays no taint role.
+  const std::vector<Entry> *lookup(const FunctionDecl *Callee) const {
+    auto It = Entries.find(Callee->getQualifiedNameAsString());
+    if (It == Entries.end() && Callee->getDeclName().isIdentifier()) {
+      It = Entries.find(Callee->getName());
+    }
+    return It != Entries.end() ? &It->second : nullptr;
+  }
+
+private:
+  void add(Entry &&E) {
+    if (!E.Name.empty()) {
+      Entries[E.Name].push_back(std::move(E));
+    }
+  }
+
+  llvm::StringMap<std::vector<Entry>> Entries;
+};
+
+/**
+ * Functions defined in project headers that some translation unit of a batch
+ * run has already exported, keyed by USR and token hash (see hashTokens).
+ * Shared by all batch workers, so an inline or template function included by
+ * N translation units gets its CFG built and exported once, by the first one
+ * to reach it; the others skip it. The hash covers the definitions of the
+ * macros the body uses, so a translation unit that sees the body through
+ * different -D flags or #defines exports its own version; a header edited
+ * between two runs hashes differently and is exported again too.
+ */
+class HeaderFunctionCache {
+public:
+  /// True for the first caller with this USR and hash, false afterwards.
+  bool claim(const std::string &USR, const std::string &Hash) {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    return Exported.insert(USR + "#" + Hash).second;
+  }
+
+  /// Give up a claim whose function could not be exported, so that another
+  /// translation unit can export it.
+  void release(const std::string &USR, const std::string &Hash) {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    Exported.erase(USR + "#" + Hash);
+  }
+
+private:
+  std::mutex Mutex;
+  std::set<std::string> Exported;
+};
+
+/**
+ * Per-export settings, shared by the visitor and every export entry point
+ * (one-shot, --serve requests and --batch workers).
+ */
+struct ExportOptions {
+  /// Receives each function record as soon as its CFG is exported (streaming
+  /// output). When set, the visitor does not accumulate function records, so
+  /// memory stays bounded by the largest function instead of the whole file.
+  std::function<void(json &&)> OnFunction;
+
+  /// Unsaved contents of the main file (e.g. an editor buffer). When set, they
+  /// are mapped over the file's path in memory and the file on disk is not
+  /// read; headers still resolve from disk as usual.
+  std::optional<std::string> MainFileContents;
+
+  /// Do not parse the bodies of functions declared outside the main file.
+  /// Only main-file CFGs are exported, so header bodies are parse time spent
+  /// for nothing (Sema still parses constexpr and auto-returning functions).
+  bool SkipHeaderFunctionBodies = false;
+
+  /// Export only functions whose qualified name, plain name or USR is listed
+  /// (all functions when empty).
+  std::vector<std::string> Functions;
+
+  /// Export only functions whose source lines overlap [first, second]
+  /// (1-based, inclusive).
+  std::optional<std::pair<unsigned, unsigned>> Lines;
+
+  /// Emit one statement per source-level statement instead of one per CFG
+  /// element. Subexpressions Clang places as separate elements in the same
+  /// block are folded into the statement that contains them and listed by
+  /// element ID only.
+  bool TopLevelStatements = false;
+
+  /// Emit a simplified CFG: unreachable blocks are dropped, empty
+  /// pass-through blocks are bypassed and chains of blocks joined by their
+  /// only edge are fused (see simplifyBlocks).
+  bool SimplifyCFG = false;
+
+  /// Maximum number of steps in the access paths of statement defs/uses (see
+  /// getAccessPath); deeper paths are cut to this prefix. 0 disables them.
+  unsigned AccessPathDepth = 3;
+
+  /// Tag call sites of the spec's sources, sinks and sanitizers with their
+  /// role (see exportTaintTags). Not tagged when null.
+  std::shared_ptr<const TaintSpec> Taint;
+
+  /// Also export functions defined in project (non-system) headers, each once
+  /// per cache (--batch --header-functions). Not exported when null.
+  std::shared_ptr<HeaderFunctionCache> HeaderFunctions;
+};
+
+/// Whether Loc is in a header whose functions Options exports: any header
+/// outside the system include directories, with a header function cache.
+static bool isExportedHeader(const SourceManager &SM, SourceLocation Loc, const ExportOptions &Options) {
+  return Options.HeaderFunctions && !SM.isInMainFile(Loc) && !SM.isInSystemHeader(Loc);
+}
+
+/// Absolute path of the file Loc is spelled in, with symlinks resolved when
+/// the file was opened from disk. Unlike the #include spelling SM.getFilename
+/// returns, it names a header the same way in every translation unit.
+static std::string getRealFilePath(const SourceManager &SM, SourceLocation Loc) {
+  SourceLocation SpellingLoc = SM.getSpellingLoc(Loc);
+  if (OptionalFileEntryRef Entry = SM.getFileEntryRefForID(SM.getFileID(SpellingLoc))) {
+    StringRef RealPath = Entry->getFileEntry().tryGetRealPathName();
+    if (!RealPath.empty()) {
+      return RealPath.str();
+    }
+  }
+  llvm::SmallString<256> Path(SM.getFilename(SpellingLoc));
+  SM.getFileManager().makeAbsolutePath(Path);
+  llvm::sys::path::remove_dots(Path, /*remove_dot_dot=*/true);
+  return std::string(Path.str());
+}
+
+/// Parse a --lines / "lines" range of the form <start>-<end> (or a single line).
+static bool parseLineRange(const std::string &Text, std::pair<unsigned, unsigned> &Range) {
+  size_t Dash = Text.find('-');
+  try {
+    Range.first = static_cast<unsigned>(std::stoul(Text.substr(0, Dash)));
+    Range.second = Dash == std::string::npos ? Range.first : static_cast<unsigned>(std::stoul(Text.substr(Dash + 1)));
+  } catch (const std::exception &) {
+    return false;
+  }
+  return Range.first <= Range.second;
+}
+
+/**
+ * Restrict AST traversal to the given top-level declarations of the main
+ * file and run the visitor. Declarations pulled in from headers (the whole
+ * standard library, typically) are neither visited nor deserialized, and
+ * with a line filter neither are main-file declarations outside the range.
+ * With a header function cache, declarations of project headers are visited
+ * too (system headers still are not).
+ */
+template <typename VisitorT>
+static void traverseMainFileDecls(ASTContext &Context, VisitorT &Visitor, const std::vector<Decl *> &TopLevelDecls,
+                                  const ExportOptions &Options) {
+  const SourceManager &SM = Context.getSourceManager();
+  std::vector<Decl *> MainFileDecls;
+  for (Decl *D : TopLevelDecls) {
+    if (isExportedHeader(SM, D->getLocation(), Options)) {
+      MainFileDecls.push_back(D);
+      continue;
+    }
+    if (!SM.isInMainFile(D->getLocation())) {
+      continue;
+    }
+    if (Options.Lines && (SM.getExpansionLineNumber(D->getEndLoc()) < Options.Lines->first ||
+                          SM.getExpansionLineNumber(D->getBeginLoc()) > Options.Lines->second)) {
+      continue;
+    }
+    MainFileDecls.push_back(D);
+  }
+
+  std::vector<Decl *> PreviousScope = Context.getTraversalScope();
+  Context.setTraversalScope(MainFileDecls);
+  Visitor.TraverseAST(Context);
+  Context.setTraversalScope(PreviousScope);
+}
+
+/// Whether Var is shared program-wide: namespace-scope variables and static
+/// data members (static locals have static storage but are function-private).
+static bool isSharedGlobal(const VarDecl *Var) {
+  return Var->hasGlobalStorage() && !Var->isStaticLocal();
+}
+
+/**
+ * Per-function table of the variables that exported statements define or
+ * use. Each variable gets a small integer ID in order of first reference;
+ * statements refer to variables by ID and the table maps IDs to names.
+ */
+class VariableTable {
+public:
+  int getID(const VarDecl *Var) {
+    Var = Var->getCanonicalDecl();
+    auto It = IDs.find(Var);
+    if (It != IDs.end()) {
+      return It->second;
+    }
+    int ID = static_cast<int>(Variables.size());
+    IDs.emplace(Var, ID);
+    Variables.push_back(Var);
+    return ID;
+  }
+
+  const VarDecl *getVariable(int ID) const { return Variables[ID]; }
+
+  json toJson() const {
+    json Table = json::array();
+    for (size_t ID = 0; ID < Variables.size(); ++ID) {
+      const VarDecl *Var = Variables[ID];
+      json Entry;
+      Entry["id"] = static_cast<int>(ID);
+      Entry["name"] = Var->getNameAsString();
+      if (isa<ParmVarDecl>(Var)) {
+        Entry["kind"] = "parameter";
+      } else if (isSharedGlobal(Var)) {
+        Entry["kind"] = "global";
+        Entry["qualifiedName"] = Var->getQualifiedNameAsString();
+      } else if (Var->isStaticLocal()) {
+        Entry["kind"] = "static";
+      } else {
+        Entry["kind"] = "local";
+      }
+      Table.push_back(std::move(Entry));
+    }
+    return Table;
+  }
+
+private:
+  std::map<const VarDecl *, int> IDs;
+  std::vector<const VarDecl *> Variables;
+};
+
+/**
+ * Per-file table of variables with static storage duration: every one
+ * declared in the main file (namespace scope, static data members, static
+ * locals) plus those from headers that exported functions access.
+ */
+class GlobalTable {
+public:
+  void add(const VarDecl *Var) {
+    Var = Var->getCanonicalDecl();
+    if (Seen.insert(Var).second) {
+      Globals.push_back(Var);
+    }
+  }
+
+  json toJson(const ASTContext &Context) const {
+    const SourceManager &SM = Context.getSourceManager();
+    json Table = json::array();
+    for (const VarDecl *Var : Globals) {
+      json Entry;
+      Entry["name"] = Var->getNameAsString();
+      Entry["qualifiedName"] = Var->getQualifiedNameAsString();
+      llvm::SmallString<128> USR;
+      if (!index::generateUSRForDecl(Var, USR)) {
+        Entry["usr"] = USR.str().str();
+      }
+      Entry["type"] = Var->getType().getAsString(Context.getPrintingPolicy());
+      Entry["kind"] = Var->isStaticLocal() ? "static" : (Var->isStaticDataMember() ? "member" : "global");
+      Entry["isConst"] = Var->getType().isConstQualified();
+      SourceLocation Loc = Var->getLocation();
+      if (Loc.isValid()) {
+        Entry["file"] = SM.getFilename(SM.getSpellingLoc(Loc)).str();
+        Entry["line"] = SM.getSpellingLineNumber(Loc);
+      }
+      Table.push_back(std::move(Entry));
+    }
+    return Table;
+  }
+
+private:
+  std::set<const VarDecl *> Seen;
+  std::vector<const VarDecl *> Globals;
+};
+
+/// The variable whose storage an lvalue expression denotes: the variable
+/// itself, or the variable containing the accessed field or array element.
+/// Null for storage reached through a pointer.
+static const VarDecl *getStoredVariable(const Expr *E) {
+  while (E) {
+    E = E->IgnoreParens();
+    if (const auto *Cast = dyn_cast<ImplicitCastExpr>(E)) {
+      CastKind Kind = Cast->getCastKind();
+      if (Kind != CK_NoOp && Kind != CK_DerivedToBase && Kind != CK_UncheckedDerivedToBase &&
+          Kind != CK_ArrayToPointerDecay) {
+        return nullptr;
+      }
+      E = Cast->getSubExpr();
+    } else if (const auto *Ref = dyn_cast<DeclRefExpr>(E)) {
+      return dyn_cast<VarDecl>(Ref->getDecl());
+    } else if (const auto *Member = dyn_cast<MemberExpr>(E)) {
+      if (Member->isArrow()) {
+        return nullptr;
+      }
+      E = Member->getBase();
+    } else if (const auto *Subscript = dyn_cast<ArraySubscriptExpr>(E)) {
+      const Expr *Base = Subscript->getBase()->IgnoreParenImpCasts();
+      if (!Base->getType()->isArrayType()) {
+        return nullptr;
+      }
+      E = Base;
+    } else {
+      return nullptr;
+    }
+  }
+  return nullptr;
+}
+
+/**
+ * Access path of the lvalue E: the variable it is rooted at, and the field,
+ * index and dereference steps applied to it, in evaluation order. `p->next->v`
+ * is p with steps deref, field next, deref, field v. Index steps carry the
+ * index when it is a constant, else null. Paths with more than MaxDepth steps
+ * are cut to their first MaxDepth steps, which stand for everything below.
+ * Returns false when E is not rooted at a variable (`this`, call results).
+ */
+static bool getAccessPath(const Expr *E, const ASTContext &Context, unsigned MaxDepth, const VarDecl *&Base,
+                          json &Steps) {
+  std::vector<json> Reversed;
+  while (E) {
+    E = E->IgnoreParens();
+    if (const auto *Cast = dyn_cast<ImplicitCastExpr>(E)) {
+      CastKind Kind = Cast->getCastKind();
+      if (Kind != CK_NoOp && Kind != CK_DerivedToBase && Kind != CK_UncheckedDerivedToBase &&
+          Kind != CK_ArrayToPointerDecay && Kind != CK_LValueToRValue) {
+        return false;
+      }
+      E = Cast->getSubExpr();
+    } else if (const auto *Ref = dyn_cast<DeclRefExpr>(E)) {
+      Base = dyn_cast<VarDecl>(Ref->getDecl());
+      break;
+    } else if (const auto *Member = dyn_cast<MemberExpr>(E)) {
+      const auto *Field = dyn_cast<FieldDecl>(Member->getMemberDecl());
+      if (!Field) {
+        return false;
+      }
+      Reversed.push_back({{"kind", "field"}, {"name", Field->getNameAsString()}});
+      if (Member->isArrow()) {
+        Reversed.push_back({{"kind", "deref"}});
+      }
+      E = Member->getBase();
+    } else if (const auto *Subscript = dyn_cast<ArraySubscriptExpr>(E)) {
+      Expr::EvalResult Index;
+      const Expr *IndexExpr = Subscript->getIdx();
+      bool IsConstant = !IndexExpr->isValueDependent() && IndexExpr->EvaluateAsInt(Index, Context);
+      Reversed.push_back({{"kind", "index"},
+                          {"index", IsConstant ? json(Index.Val.getInt().getExtValue()) : json(nullptr)}});
+      E = Subscript->getBase();
+    } else if (const auto *Deref = dyn_cast<UnaryOperator>(E); Deref && Deref->getOpcode() == UO_Deref) {
+      Reversed.push_back({{"kind", "deref"}});
+      E = Deref->getSubExpr();
+    } else {
+      return false;
+    }
+  }
+  if (!Base) {
+    return false;
+  }
+  Steps = json::array();
+  for (auto It = Reversed.rbegin(); It != Reversed.rend() && Steps.size() < MaxDepth; ++It) {
+    Steps.push_back(std::move(*It));
+  }
+  return true;
+}
+
+/**
+ * DEF and USE sets of one statement, computed from its AST.
+ *
+ * A variable is USED where its value is read: an lvalue-to-rvalue conversion
+ * of the variable (or of a field/element of it), the operand of a compound
+ * assignment or ++/--, an argument bound to a reference parameter, or the
+ * object of a member call. It is DEFINED by its declaration, as the target of
+ * an assignment, compound assignment or ++/--, and when passed by non-const
+ * reference or by address to a non-const pointer parameter (out parameters
+ * such as scanf). Assignments to a field or array element define the whole
+ * variable; writes through pointers define no variable. Unevaluated operands
+ * (sizeof, alignof) and lambda bodies are not examined.
+ *
+ * The sets cover the whole subtree of the statement, so they are exact both
+ * for CFG elements of single subexpressions and for full statements.
+ */
+class DefUseCollector {
+public:
+  explicit DefUseCollector(VariableTable &Variables) : Variables(Variables) {}
+
+  void collect(const Stmt *S) { visit(S); }
+
+  /// DEF/USE of a call argument, including the effect of binding it to a
+  /// parameter of ParamType (null for variadic arguments).
+  void collectArgument(const Expr *Arg, QualType ParamType) {
+    visit(Arg);
+    if (!ParamType.isNull()) {
+      visitArgument(Arg, ParamType);
+    }
+  }
+
+  /// Also record the access paths (see getAccessPath) of the fields,
+  /// elements and pointees written and read, up to MaxDepth steps.
+  void trackAccessPaths(const ASTContext &PathContext, unsigned MaxDepth) {
+    Context = &PathContext;
+    AccessPathDepth = MaxDepth;
+  }
+
+  const std::set<int> &defs() const { return Defs; }
+  const std::set<int> &uses() const { return Uses; }
+  json defsJson() const { return json(Defs); }
+  json usesJson() const { return json(Uses); }
+  json defPathsJson() const { return json(DefPaths); }
+  json usePathsJson() const { return json(UsePaths); }
+
+private:
+  /// Add the access path of E to Paths if it has at least one step; plain
+  /// variables are already in Defs/Uses.
+  void addAccessPath(std::set<json> &Paths, const Expr *E) {
+    const VarDecl *Base = nullptr;
+    json Steps;
+    if (!Context || AccessPathDepth == 0 || !getAccessPath(E, *Context, AccessPathDepth, Base, Steps) ||
+        Steps.empty()) {
+      return;
+    }
+    Paths.insert(json{{"base", Variables.getID(Base)}, {"steps", std::move(Steps)}});
+  }
+
+  void visit(const Stmt *S) {
+    if (!S) {
+      return;
+    }
+
+    if (const auto *DS = dyn_cast<DeclStmt>(S)) {
+      for (const Decl *D : DS->decls()) {
+        // Block-scope extern declarations only name a global
+        if (const auto *Var = dyn_cast<VarDecl>(D); Var && !Var->hasExternalStorage()) {
+          Defs.insert(Variables.getID(Var));
+          visit(Var->getInit());
+        }
+      }
+      return;
+    }
+
+    if (const auto *BO = dyn_cast<BinaryOperator>(S)) {
+      if (BO->isAssignmentOp()) {
+        addAccessPath(DefPaths, BO->getLHS());
+        if (BO->isCompoundAssignmentOp()) {
+          addAccessPath(UsePaths, BO->getLHS());
+        }
+        if (const VarDecl *Var = getStoredVariable(BO->getLHS())) {
+          Defs.insert(Variables.getID(Var));
+          if (BO->isCompoundAssignmentOp()) {
+            Uses.insert(Variables.getID(Var));
+          }
+        }
+      }
+      visitChildren(S);
+      return;
+    }
+
+    if (const auto *UO = dyn_cast<UnaryOperator>(S)) {
+      if (UO->isIncrementDecrementOp()) {
+        addAccessPath(DefPaths, UO->getSubExpr());
+        addAccessPath(UsePaths, UO->getSubExpr());
+        if (const VarDecl *Var = getStoredVariable(UO->getSubExpr())) {
+          Defs.insert(Variables.getID(Var));
+          Uses.insert(Variables.getID(Var));
+        }
+      }
+      visitChildren(S);
+      return;
+    }
+
+    if (const auto *Cast = dyn_cast<ImplicitCastExpr>(S)) {
+      if (Cast->getCastKind() == CK_LValueToRValue) {
+        addAccessPath(UsePaths, Cast->getSubExpr());
+        if (const VarDecl *Var = getStoredVariable(Cast->getSubExpr())) {
+          Uses.insert(Variables.getID(Var));
+        }
+      }
+      visitChildren(S);
+      return;
+    }
+
+    if (isa<UnaryExprOrTypeTraitExpr>(S)) {
+      return;
+    }
+
+    if (const auto *Lambda = dyn_cast<LambdaExpr>(S)) {
+      for (const Expr *Init : Lambda->capture_inits()) {
+        visit(Init);
+      }
+      return;
+    }
+
+    if (const auto *Call = dyn_cast<CallExpr>(S)) {
+      visitCall(Call);
+      visitChildren(S);
+      return;
+    }
+
+    if (const auto *Construct = dyn_cast<CXXConstructExpr>(S)) {
+      const CXXConstructorDecl *Ctor = Construct->getConstructor();
+      for (unsigned I = 0; I < Construct->getNumArgs() && Ctor && I < Ctor->getNumParams(); ++I) {
+        visitArgument(Construct->getArg(I), Ctor->getParamDecl(I)->getType());
+      }
+      visitChildren(S);
+      return;
+    }
+
+    visitChildren(S);
+  }
+
+  void visitChildren(const Stmt *S) {
+    for (const Stmt *Child : S->children()) {
+      visit(Child);
+    }
+  }
+
+  void visitCall(const CallExpr *Call) {
+    const auto *Callee = dyn_cast_or_null<FunctionDecl>(Call->getCalleeDecl());
+
+    // Overloaded assignment, compound assignment and ++/-- on class types
+    if (const auto *OpCall = dyn_cast<CXXOperatorCallExpr>(Call)) {
+      OverloadedOperatorKind Op = OpCall->getOperator();
+      if (OpCall->getNumArgs() > 0 && (OpCall->isAssignmentOp() || Op == OO_PlusPlus || Op == OO_MinusMinus)) {
+        if (const VarDecl *Var = getStoredVariable(OpCall->getArg(0))) {
+          Defs.insert(Variables.getID(Var));
+          if (Op != OO_Equal) {
+            Uses.insert(Variables.getID(Var));
+          }
+        }
+      }
+    }
+
+    // Object of a member call: read, and written unless the method is const
+    if (const auto *MemberCall = dyn_cast<CXXMemberCallExpr>(Call)) {
+      const Expr *Object = MemberCall->getImplicitObjectArgument();
+      if (Object && Object->isGLValue()) {
+        if (const VarDecl *Var = getStoredVariable(Object)) {
+          Uses.insert(Variables.getID(Var));
+          const CXXMethodDecl *Method = MemberCall->getMethodDecl();
+          if (Method && !Method->isConst()) {
+            Defs.insert(Variables.getID(Var));
+          }
+        }
+      }
+    }
+
+    if (!Callee) {
+      return;
+    }
+    // Member operators take the object as argument 0 and have no parameter for it
+    unsigned FirstArg = isa<CXXOperatorCallExpr>(Call) && isa<CXXMethodDecl>(Callee) ? 1 : 0;
+    for (unsigned I = FirstArg; I < Call->getNumArgs() && I - FirstArg < Callee->getNumParams(); ++I) {
+      visitArgument(Call->getArg(I), Callee->getParamDecl(I - FirstArg)->getType());
+    }
+  }
+
+  /// Reference and out-parameter arguments; by-value arguments are read
+  /// through their own lvalue-to-rvalue conversion.
+  void visitArgument(const Expr *Arg, QualType ParamType) {
+    if (ParamType->isReferenceType() && Arg->isGLValue()) {
+      if (const VarDecl *Var = getStoredVariable(Arg)) {
+        Uses.insert(Variables.getID(Var));
+        if (!ParamType.getNonReferenceType().isConstQualified()) {
+          Defs.insert(Variables.getID(Var));
+        }
+      }
+      return;
+    }
+
+    if (ParamType->isPointerType() && !ParamType->getPointeeType().isConstQualified()) {
+      const auto *AddrOf = dyn_cast<UnaryOperator>(Arg->IgnoreParenImpCasts());
+      if (AddrOf && AddrOf->getOpcode() == UO_AddrOf) {
+        if (const VarDecl *Var = getStoredVariable(AddrOf->getSubExpr())) {
+          Defs.insert(Variables.getID(Var));
+          Uses.insert(Variables.getID(Var));
+        }
+      }
+    }
+  }
+
+  VariableTable &Variables;
+  std::set<int> Defs;
+  std::set<int> Uses;
+  const ASTContext *Context = nullptr;
+  unsigned AccessPathDepth = 0;
+  std::set<json> DefPaths;
+  std::set<json> UsePaths;
+};
+
+/**
+ * For each element of Block, the index of the element in the same block whose
+ * statement contains it, or -1 for top-level elements. Clang emits
+ * subexpressions before the expressions that contain them, so walking the
+ * block backwards reaches every top-level element before its subexpressions
+ * and each subtree is walked once.
+ */
+static std::vector<int> findEnclosingElements(const CFGBlock &Block) {
+  std::map<const Stmt *, int> Indices;
+  for (size_t I = 0; I < Block.size(); ++I) {
+    if (auto StmtElem = Block[I].getAs<CFGStmt>()) {
+      Indices.emplace(StmtElem->getStmt(), static_cast<int>(I));
+    }
+  }
+
+  std::vector<int> Enclosing(Block.size(), -1);
+  for (int I = static_cast<int>(Block.size()) - 1; I >= 0; --I) {
+    auto StmtElem = Block[I].getAs<CFGStmt>();
+    if (!StmtElem || Enclosing[I] != -1) {
+      continue;
+    }
+    std::vector<const Stmt *> Worklist;
+    for (const Stmt *Child : StmtElem->getStmt()->children()) {
+      Worklist.push_back(Child);
+    }
+    while (!Worklist.empty()) {
+      const Stmt *S = Worklist.back();
+      Worklist.pop_back();
+      if (!S) {
+        continue;
+      }
+      auto It = Indices.find(S);
+      if (It != Indices.end() && It->second < I) {
+        Enclosing[It->second] = I;
+      }
+      for (const Stmt *Child : S->children()) {
+        Worklist.push_back(Child);
+      }
+    }
+  }
+  return Enclosing;
+}
+
+/// The statement that consumes the value of E, skipping parentheses, implicit
+/// conversions and temporary bookkeeping. E is updated to the outermost
+/// skipped expression (the consumer's direct child).
+static const Stmt *getValueConsumer(const ParentMap &Parents, const Expr *&E) {
+  const Stmt *Parent = Parents.getParent(E);
+  while (Parent) {
+    const auto *Construct = dyn_cast<CXXConstructExpr>(Parent);
+    if (!isa<ParenExpr>(Parent) && !isa<ImplicitCastExpr>(Parent) && !isa<ExprWithCleanups>(Parent) &&
+        !isa<CXXBindTemporaryExpr>(Parent) && !isa<MaterializeTemporaryExpr>(Parent) &&
+        !(Construct && Construct->isElidable())) {
+      break;
+    }
+    E = cast<Expr>(Parent);
+    Parent = Parents.getParent(Parent);
+  }
+  return Parent;
+}
+
+/// Whether the value of E (a direct child of Consumer) is used. Values outside
+/// the function body (member initializers, default arguments) are used.
+static bool isValueUsed(const Stmt *Consumer, const Expr *E) {
+  if (!Consumer) {
+    return true;
+  }
+  if (const auto *Cast = dyn_cast<ExplicitCastExpr>(Consumer)) {
+    return !Cast->getType()->isVoidType();
+  }
+  if (const auto *BO = dyn_cast<BinaryOperator>(Consumer)) {
+    return BO->getOpcode() != BO_Comma || BO->getRHS() == E;
+  }
+  if (isa<Expr>(Consumer) || isa<ReturnStmt>(Consumer) || isa<DeclStmt>(Consumer)) {
+    return true;
+  }
+  if (const auto *If = dyn_cast<IfStmt>(Consumer)) {
+    return If->getCond() == E;
+  }
+  if (const auto *While = dyn_cast<WhileStmt>(Consumer)) {
+    return While->getCond() == E;
+  }
+  if (const auto *Do = dyn_cast<DoStmt>(Consumer)) {
+    return Do->getCond() == E;
+  }
+  if (const auto *For = dyn_cast<ForStmt>(Consumer)) {
+    return For->getCond() == E;
+  }
+  if (const auto *Switch = dyn_cast<SwitchStmt>(Consumer)) {
+    return Switch->getCond() == E;
+  }
+  // Expression statement: the value is discarded
+  return false;
+}
+
+/// The variable the value of E is stored into by Consumer: the target of an
+/// assignment or the variable it initializes.
+static const VarDecl *getAssignedVariable(const Stmt *Consumer, const Expr *E) {
+  if (const auto *BO = dyn_cast_or_null<BinaryOperator>(Consumer)) {
+    if (BO->isAssignmentOp() && BO->getRHS() == E) {
+      return getStoredVariable(BO->getLHS());
+    }
+  } else if (const auto *OpCall = dyn_cast_or_null<CXXOperatorCallExpr>(Consumer)) {
+    if (OpCall->isAssignmentOp() && OpCall->getNumArgs() == 2 && OpCall->getArg(1) == E) {
+      return getStoredVariable(OpCall->getArg(0));
+    }
+  } else if (const auto *DS = dyn_cast_or_null<DeclStmt>(Consumer)) {
+    for (const Decl *D : DS->decls()) {
+      const auto *Var = dyn_cast<VarDecl>(D);
+      if (Var && Var->getInit() == E) {
+        return Var;
+      }
+    }
+  }
+  return nullptr;
+}
+
+/// Block ID of the immediate (post-)dominator of Block in Tree, or null for
+/// the tree's root and for blocks the tree does not reach.
+template <bool IsPostDom>
+static json immediateDominatorID(CFGDominatorTreeImpl<IsPostDom> &Tree, CFGBlock *Block) {
+  auto *Node = Tree.getNode(Block);
+  if (!Node || !Node->getIDom() || !Node->getIDom()->getBlock()) {
+    return nullptr;
+  }
+  return static_cast<int>(Node->getIDom()->getBlock()->getBlockID());
+}
+
+/// Traversal order and natural loops of a CFG, indexed by block ID. Blocks
+/// unreachable from the entry have no order index (-1) and are in no loop.
+struct CFGOrder {
+  std::vector<int> Postorder;
+  std::vector<int> ReversePostorder;
+  std::vector<std::vector<int>> BackEdges;  // Successors reached by a back edge
+  std::vector<int> LoopHeader;              // Innermost enclosing loop, or -1
+  std::vector<int> LoopDepth;
+};
+
+/// Depth-first order from the entry, back edges (edges to a dominator) and
+/// the natural loop of each loop header.
+static CFGOrder computeCFGOrder(CFG &Graph, CFGDomTree &Dominators) {
+  unsigned NumBlocks = Graph.getNumBlockIDs();
+  CFGOrder Order;
+  Order.Postorder.assign(NumBlocks, -1);
+  Order.ReversePostorder.assign(NumBlocks, -1);
+  Order.BackEdges.resize(NumBlocks);
+  Order.LoopHeader.assign(NumBlocks, -1);
+  Order.LoopDepth.assign(NumBlocks, 0);
+
+  // Iterative DFS; null successors are edges Clang proved infeasible
+  std::vector<bool> Visited(NumBlocks, false);
+  std::vector<std::pair<CFGBlock *, CFGBlock::succ_iterator>> Stack;
+  int NextIndex = 0;
+  CFGBlock *Entry = &Graph.getEntry();
+  Visited[Entry->getBlockID()] = true;
+  Stack.push_back({Entry, Entry->succ_begin()});
+  while (!Stack.empty()) {
+    CFGBlock *Block = Stack.back().first;
+    CFGBlock::succ_iterator &Next = Stack.back().second;
+    if (Next == Block->succ_end()) {
+      Order.Postorder[Block->getBlockID()] = NextIndex++;
+      Stack.pop_back();
+      continue;
+    }
+    CFGBlock *Succ = *Next++;
+    if (Succ && !Visited[Succ->getBlockID()]) {
+      Visited[Succ->getBlockID()] = true;
+      Stack.push_back({Succ, Succ->succ_begin()});
+    }
+  }
+  for (unsigned ID = 0; ID < NumBlocks; ++ID) {
+    if (Order.Postorder[ID] != -1) {
+      Order.ReversePostorder[ID] = NextIndex - 1 - Order.Postorder[ID];
+    }
+  }
+
+  // Natural loop of each header: the header plus every block that reaches
+  // one of its back edges without passing through it
+  std::map<CFGBlock *, std::vector<bool>> Loops;
+  for (CFGBlock *Block : Graph) {
+    if (Order.Postorder[Block->getBlockID()] == -1) {
+      continue;
+    }
+    for (CFGBlock *Succ : Block->succs()) {
+      if (!Succ || !Dominators.dominates(Succ, Block)) {
+        continue;
+      }
+      Order.BackEdges[Block->getBlockID()].push_back(Succ->getBlockID());
+
+      std::vector<bool> &Body = Loops[Succ];
+      Body.resize(NumBlocks, false);
+      Body[Succ->getBlockID()] = true;
+      std::vector<CFGBlock *> Worklist;
+      if (!Body[Block->getBlockID()]) {
+        Body[Block->getBlockID()] = true;
+        Worklist.push_back(Block);
+      }
+      while (!Worklist.empty()) {
+        CFGBlock *Current = Worklist.back();
+        Worklist.pop_back();
+        for (CFGBlock *Pred : Current->preds()) {
+          if (Pred && Order.Postorder[Pred->getBlockID()] != -1 && !Body[Pred->getBlockID()]) {
+            Body[Pred->getBlockID()] = true;
+            Worklist.push_back(Pred);
+          }
+        }
+      }
+    }
+  }
+
+  // Loops nest, so the innermost loop containing a block is the smallest
+  std::vector<size_t> InnermostSize(NumBlocks, SIZE_MAX);
+  for (const auto &[Header, Body] : Loops) {
+    size_t Size = std::count(Body.begin(), Body.end(), true);
+    for (unsigned ID = 0; ID < NumBlocks; ++ID) {
+      if (!Body[ID]) {
+        continue;
+      }
+      ++Order.LoopDepth[ID];
+      if (Size < InnermostSize[ID]) {
+        InnermostSize[ID] = Size;
+        Order.LoopHeader[ID] = Header->getBlockID();
+      }
+    }
+  }
+  return Order;
+}
+
+/// Simplified form of one function's exported block records (--simplify-cfg).
+///
+/// Blocks unreachable from the entry (e.g. behind a pruned trivially false
+/// edge) are dropped, except the exit. Empty blocks without a terminator and
+/// with a single successor are bypassed. A block whose only successor has no
+/// other predecessor absorbs it, repeatedly, so straight-line chains become
+/// one block keyed by the first block's ID; it takes its statements and
+/// calls from the whole chain and its terminator and successors from the last
+/// block. All block references are remapped, and "mergedBlocks" lists the
+/// original Clang blocks each result stands for. Statement IDs keep the
+/// original <block>.<index> notation; rpo/postorder keep the first block's
+/// index (ordered, with gaps).
+static json simplifyBlocks(const json &Blocks) {
+  std::map<int, const json *> ByID;
+  for (const json &Block : Blocks) {
+    ByID[Block["id"].get<int>()] = &Block;
+  }
+  auto IsReachable = [&](int ID) {
+    const json &Block = *ByID.at(ID);
+    return !Block["rpo"].is_null() || Block["isExit"].get<bool>();
+  };
+
+  // Empty pass-through blocks forward to their successor; a cycle of them
+  // (`for (;;) {}`) keeps the block where it closes
+  std::map<int, int> Forward;
+  for (const json &Block : Blocks) {
+    int ID = Block["id"].get<int>();
+    if (IsReachable(ID) && !Block["isEntry"].get<bool>() && !Block["isExit"].get<bool>() &&
+        Block["statements"].empty() && Block["calls"].empty() && Block["terminator"].is_null() &&
+        Block["successors"].size() == 1) {
+      Forward[ID] = Block["successors"][0].get<int>();
+    }
+  }
+  for (const json &Block : Blocks) {
+    std::set<int> Seen;
+    int Current = Block["id"].get<int>();
+    while (Forward.count(Current) && Seen.insert(Current).second) {
+      Current = Forward[Current];
+    }
+    Forward.erase(Current);
+  }
+  auto Resolve = [&](int ID) {
+    while (Forward.count(ID)) {
+      ID = Forward[ID];
+    }
+    return ID;
+  };
+  auto IsKept = [&](int ID) { return IsReachable(ID) && !Forward.count(ID); };
+
+  // Successors with forwarding blocks bypassed, and predecessor counts
+  std::map<int, std::vector<int>> Successors;
+  std::map<int, int> PredecessorCount;
+  for (const json &Block : Blocks) {
+    int ID = Block["id"].get<int>();
+    if (!IsKept(ID)) {
+      continue;
+    }
+    std::vector<int> &Succs = Successors[ID];
+    for (const json &Succ : Block["successors"]) {
+      int Target = Resolve(Succ.get<int>());
+      if (std::find(Succs.begin(), Succs.end(), Target) == Succs.end()) {
+        Succs.push_back(Target);
+        ++PredecessorCount[Target];
+      }
+    }
+  }
+
+  // Fuse each block into its only predecessor when that predecessor has no
+  // other successor and does not branch on a condition
+  auto FusedSuccessor = [&](int ID) -> std::optional<int> {
+    const json &Block = *ByID.at(ID);
+    const json &Terminator = Block["terminator"];
+    if (Successors[ID].size() != 1 || Block["isExit"].get<bool>() ||
+        (!Terminator.is_null() && !Terminator["condition"].is_null())) {
+      return std::nullopt;
+    }
+    int Next = Successors[ID][0];
+    const json &NextBlock = *ByID.at(Next);
+    if (Next == ID || PredecessorCount[Next] != 1 || NextBlock["isEntry"].get<bool>() ||
+        NextBlock["isExit"].get<bool>()) {
+      return std::nullopt;
+    }
+    return Next;
+  };
+  std::set<int> Absorbed;
+  for (const auto &[ID, Succs] : Successors) {
+    if (auto Next = FusedSuccessor(ID)) {
+      Absorbed.insert(*Next);
+    }
+  }
+
+  std::map<int, int> GroupOf;
+  std::vector<std::pair<int, std::vector<int>>> Groups;
+  for (const json &Block : Blocks) {
+    int Head = Block["id"].get<int>();
+    if (!IsKept(Head) || Absorbed.count(Head)) {
+      continue;
+    }
+    std::vector<int> Members{Head};
+    GroupOf[Head] = Head;
+    for (auto Next = FusedSuccessor(Head); Next && !GroupOf.count(*Next); Next = FusedSuccessor(*Next)) {
+      Members.push_back(*Next);
+      GroupOf[*Next] = Head;
+    }
+    Groups.push_back({Head, std::move(Members)});
+  }
+
+  std::map<int, std::vector<int>> Merged;
+  for (const auto &[Head, Members] : Groups) {
+    Merged[Head] = Members;
+  }
+  for (const auto &[ID, Target] : Forward) {
+    auto Group = GroupOf.find(Resolve(ID));
+    if (Group != GroupOf.end()) {
+      Merged[Group->second].push_back(ID);
+    }
+  }
+
+  auto MapID = [&](const json &ID) -> json {
+    if (ID.is_null() || !IsReachable(ID.get<int>())) {
+      return nullptr;
+    }
+    auto It = GroupOf.find(Resolve(ID.get<int>()));
+    return It != GroupOf.end() ? json(It->second) : json(nullptr);
+  };
+  auto MapIDs = [&](const json &IDs) {
+    json Mapped = json::array();
+    for (const json &ID : IDs) {
+      json Target = MapID(ID);
+      if (!Target.is_null() && std::find(Mapped.begin(), Mapped.end(), Target) == Mapped.end()) {
+        Mapped.push_back(Target);
+      }
+    }
+    return Mapped;
+  };
+  // A bypassed block's dominator is its own immediate dominator's group
+  auto MapDominator = [&](json ID) -> json {
+    while (!ID.is_null() && Forward.count(ID.get<int>())) {
+      ID = (*ByID.at(ID.get<int>()))["immediateDominator"];
+    }
+    return MapID(ID);
+  };
+
+  json Result = json::array();
+  std::map<int, json> Predecessors;
+  for (const auto &[Head, Members] : Groups) {
+    const json &First = *ByID.at(Head);
+    const json &Last = *ByID.at(Members.back());
+
+    json Block = First;
+    json Statements = json::array();
+    json Calls = json::array();
+    for (int Member : Members) {
+      const json &MemberBlock = *ByID.at(Member);
+      Statements.insert(Statements.end(), MemberBlock["statements"].begin(), MemberBlock["statements"].end());
+      Calls.insert(Calls.end(), MemberBlock["calls"].begin(), MemberBlock["calls"].end());
+    }
+    Block["statements"] = std::move(Statements);
+    Block["calls"] = std::move(Calls);
+    Block["isExit"] = Last["isExit"];
+    Block["terminator"] = Last["terminator"];
+    if (!Last["terminator"].is_null()) {
+      Block["terminator"]["trueSuccessor"] = MapID(Last["terminator"]["trueSuccessor"]);
+      Block["terminator"]["falseSuccessor"] = MapID(Last["terminator"]["falseSuccessor"]);
+    }
+    Block["successors"] = MapIDs(Last["successors"]);
+    Block["infeasibleSuccessors"] = MapIDs(Last["infeasibleSuccessors"]);
+    for (const json &Succ : Block["successors"]) {
+      Predecessors[Succ.get<int>()].push_back(Head);
+    }
+    Block["immediateDominator"] = MapDominator(First["immediateDominator"]);
+    Block["immediatePostDominator"] = MapID(Last["immediatePostDominator"]);
+    Block["controlDependencies"] = MapIDs(First["controlDependencies"]);
+    Block["backEdges"] = MapIDs(Last["backEdges"]);
+    Block["loopHeader"] = MapID(First["loopHeader"]);
+    Block["mergedBlocks"] = Merged[Head];
+    Result.push_back(std::move(Block));
+  }
+  for (json &Block : Result) {
+    Block["predecessors"] = Predecessors.count(Block["id"].get<int>()) ? json(Predecessors[Block["id"].get<int>()])
+                                                                        : json::array();
+  }
+  return Result;
+}
+
+/// ID of a CFG element, in the <block>.<index> notation of Clang's CFG dump.
+static std::string elementID(const CFGBlock &Block, size_t Index) {
+  return std::to_string(Block.getBlockID()) + "." + std::to_string(Index + 1);
+}
+
+/**
+ * Declarations a function body refers to (variables, functions, fields,
+ * enumerators, constructors), each as "<USR> <canonical type>", plus the
+ * value of enumerators. Sorted, so the set hashes the same in every run.
+ */
+class ReferencedDeclCollector : public RecursiveASTVisitor<ReferencedDeclCollector> {
+public:
+  explicit ReferencedDeclCollector(const ASTContext &Context) : Context(Context) {}
+
+  bool VisitDeclRefExpr(DeclRefExpr *E) {
+    add(E->getDecl());
+    return true;
+  }
+
+  bool VisitMemberExpr(MemberExpr *E) {
+    add(E->getMemberDecl());
+    return true;
+  }
+
+  bool VisitCXXConstructExpr(CXXConstructExpr *E) {
+    add(E->getConstructor());
+    return true;
+  }
+
+  const std::set<std::string> &getDecls() const { return Decls; }
+
+private:
+  void add(const ValueDecl *D) {
+    llvm::SmallString<128> USR;
+    if (!D || index::generateUSRForDecl(D, USR)) {
+      return;
+    }
+    std::string Entry = USR.str().str() + " " + D->getType().getCanonicalType().getAsString(Context.getPrintingPolicy());
+    if (const auto *Enumerator = dyn_cast<EnumConstantDecl>(D)) {
+      Entry += " = " + llvm::toString(Enumerator->getInitVal(), 10);
+    }
+    Decls.insert(std::move(Entry));
+  }
+
+  const ASTContext &Context;
+  std::set<std::string> Decls;
+};
+
+class CFGExporterVisitor : public RecursiveASTVisitor<CFGExporterVisitor> {
+public:
+  CFGExporterVisitor(ASTContext &Context, Preprocessor &PP, const ExportOptions &Options)
+      : Context(Context), PP(PP), Options(Options) {}
+
+  bool VisitVarDecl(VarDecl *Var) {
+    if (Var->hasGlobalStorage() && !isa<ParmVarDecl>(Var) &&
+        Context.getSourceManager().isInMainFile(Var->getLocation())) {
+      Globals.add(Var);
+    }
+    return true;
+  }
+
+  bool VisitFunctionDecl(FunctionDecl *Func) {
+    if (!Func->hasBody()) {
+      return true;
+    }
+
+    Stmt *Body = Func->getBody();
+    auto &SM = Context.getSourceManager();
+
+    // Skip functions not in main file, except project header functions with
+    // a header function cache
+    bool IsHeaderFunction = !SM.isInMainFile(Func->getLocation());
+    if (IsHeaderFunction && !isExportedHeader(SM, Func->getLocation(), Options)) {
+      return true;
+    }
+
+    // Selective export: decide before the (expensive) CFG is built
+    if (!isSelected(Func)) {
+      return true;
+    }
+
+    llvm::SmallString<128> USR;
+    bool HaveUSR = !index::generateUSRForDecl(Func, USR);
+    // Another translation unit has exported (or is exporting) this body
+    std::string TokenHash;
+    if (IsHeaderFunction) {
+      TokenHash = hashTokens(Func);
+      if (!HaveUSR || !Options.HeaderFunctions->claim(USR.str().str(), TokenHash)) {
+        return true;
+      }
+    }
+
+    // Edges out of branches on constant conditions are cut in every mode (see
+    // infeasibleSuccessors); --simplify-cfg also drops the blocks left behind
+    CFG::BuildOptions BuildOptions;
+    BuildOptions.PruneTriviallyFalseEdges = true;
+    std::unique_ptr<CFG> cfg = CFG::buildCFG(Func, Body, &Context, BuildOptions);
+    if (!cfg) {
+      if (IsHeaderFunction) {
+        Options.HeaderFunctions->release(USR.str().str(), TokenHash);
+      }
+      return true;
+    }
+
+    json funcJson;
+    funcJson["name"] = Func->getNameInfo().getName().getAsString();
+
+    SourceLocation Loc = Func->getBeginLoc();
+    if (Loc.isValid()) {
+      funcJson["range"]["start"]["line"] = SM.getSpellingLineNumber(Loc);
+      funcJson["range"]["start"]["column"] = SM.getSpellingColumnNumber(Loc);
+      // Header functions are grouped by header across translation units
+      funcJson["file"] = IsHeaderFunction ? getRealFilePath(SM, Loc) : SM.getFilename(Loc).str();
+    }
+    funcJson["signature"] = exportSignature(Func);
+    funcJson["usr"] = HaveUSR ? json(USR.str().str()) : json(nullptr);
+    if (IsHeaderFunction) {
+      funcJson["header"] = true;
+    }
+    if (Options.Taint) {
+      funcJson["taintTagged"] = true;
+    }
+
+    json blocksJson = json::array();
+    VariableTable Variables;
+    ParentMap Parents(Body);
+    std::set<int> GlobalReads;
+    std::set<int> GlobalWrites;
+    CFGDomTree Dominators(cfg.get());
+    ControlDependencyCalculator ControlDependencies(cfg.get());
+    CFGPostDomTree &PostDominators = ControlDependencies.getCFGPostDomTree();
+    CFGOrder Order = computeCFGOrder(*cfg, Dominators);
+
+    for (CFGBlock *Block : *cfg) {
+      json blockJson;
+      blockJson["id"] = static_cast<int>(Block->getBlockID());
+      bool isEntry = (Block == &cfg->getEntry());
+      bool isExit = Block->succ_empty();
+      blockJson["label"] = isEntry ? "Entry" : (isExit ? "Exit" : ("B" + std::to_string(Block->getBlockID())));
+      blockJson["isEntry"] = isEntry;
+      blockJson["isExit"] = isExit;
+
+      json statementsJson = json::array();
+      std::vector<int> Enclosing;
+      if (Options.TopLevelStatements) {
+        Enclosing = findEnclosingElements(*Block);
+      }
+
+      json callsJson = json::array();
+
+      for (size_t Index = 0; Index < Block->size(); ++Index) {
+        bool IsNested = !Enclosing.empty() && Enclosing[Index] != -1;
+
+        // Every evaluated call is a CFG element of the block it runs in
+        if (auto StmtElem = (*Block)[Index].getAs<CFGStmt>()) {
+          const auto *Call = dyn_cast<CallExpr>(StmtElem->getStmt());
+          if (Call && !isa<CXXOperatorCallExpr>(Call)) {
+            callsJson.push_back(exportCallSite(Call, Parents, Variables,
+                                               elementID(*Block, IsNested ? Enclosing[Index] : Index)));
+          }
+        }
+
+        if (IsNested) {
+          continue;
+        }
+        if (auto StmtElem = (*Block)[Index].getAs<CFGStmt>()) {
+          const Stmt *S = StmtElem->getStmt();
+
+          std::string stmtStr;
+          llvm::raw_string_ostream stream(stmtStr);
+          S->printPretty(stream, nullptr, Context.getPrintingPolicy());
+
+          json stmtJson;
+          stmtJson["id"] = elementID(*Block, Index);
+          stmtJson["text"] = stream.str();
+
+          if (Options.TopLevelStatements) {
+            json NestedJson = json::array();
+            for (size_t Inner = 0; Inner < Index; ++Inner) {
+              if (Enclosing[Inner] == static_cast<int>(Index)) {
+                NestedJson.push_back(elementID(*Block, Inner));
+              }
+            }
+            stmtJson["nested"] = std::move(NestedJson);
+          }
+
+          auto BeginLoc = S->getBeginLoc();
+          auto EndLoc = S->getEndLoc();
+
+          stmtJson["range"]["start"]["line"] = SM.getSpellingLineNumber(BeginLoc);
+          stmtJson["range"]["start"]["column"] = SM.getSpellingColumnNumber(BeginLoc);
+          stmtJson["range"]["end"]["line"] = SM.getSpellingLineNumber(EndLoc);
+          stmtJson["range"]["end"]["column"] = SM.getSpellingColumnNumber(EndLoc);
+
+          DefUseCollector DefUse(Variables);
+          DefUse.trackAccessPaths(Context, Options.AccessPathDepth);
+          DefUse.collect(S);
+          stmtJson["defs"] = DefUse.defsJson();
+          stmtJson["uses"] = DefUse.usesJson();
+          stmtJson["defPaths"] = DefUse.defPathsJson();
+          stmtJson["usePaths"] = DefUse.usePathsJson();
+          recordGlobalAccess(Variables, DefUse.defs(), GlobalWrites);
+          recordGlobalAccess(Variables, DefUse.uses(), GlobalReads);
+
+          statementsJson.push_back(stmtJson);
+        }
+      }
+
+      blockJson["statements"] = statementsJson;
+      blockJson["calls"] = std::move(callsJson);
+      blockJson["terminator"] = exportTerminator(*Block, Enclosing, Variables);
+
+      json succJson = json::array();
+      for (auto SuccIt = Block->succ_begin(); SuccIt != Block->succ_end(); ++SuccIt) {
+        if (const CFGBlock *Succ = *SuccIt) {
+          succJson.push_back(static_cast<int>(Succ->getBlockID()));
+        }
+      }
+      blockJson["successors"] = succJson;
+
+      json InfeasibleJson = json::array();
+      for (const CFGBlock::AdjacentBlock &Succ : Block->succs()) {
+        if (!Succ.isReachable() && Succ.getPossiblyUnreachableBlock()) {
+          InfeasibleJson.push_back(static_cast<int>(Succ.getPossiblyUnreachableBlock()->getBlockID()));
+        }
+      }
+      blockJson["infeasibleSuccessors"] = std::move(InfeasibleJson);
+
+      json predJson = json::array();
+      for (auto PredIt = Block->pred_begin(); PredIt != Block->pred_end(); ++PredIt) {
+        if (const CFGBlock *Pred = *PredIt) {
+          predJson.push_back(static_cast<int>(Pred->getBlockID()));
+        }
+      }
+      blockJson["predecessors"] = predJson;
+
+      blockJson["immediateDominator"] = immediateDominatorID(Dominators, Block);
+      blockJson["immediatePostDominator"] = immediateDominatorID(PostDominators, Block);
+      json ControlJson = json::array();
+      for (const CFGBlock *Controller : ControlDependencies.getControlDependencies(Block)) {
+        ControlJson.push_back(static_cast<int>(Controller->getBlockID()));
+      }
+      blockJson["controlDependencies"] = std::move(ControlJson);
+
+      unsigned ID = Block->getBlockID();
+      blockJson["rpo"] = Order.ReversePostorder[ID] != -1 ? json(Order.ReversePostorder[ID]) : json(nullptr);
+      blockJson["postorder"] = Order.Postorder[ID] != -1 ? json(Order.Postorder[ID]) : json(nullptr);
+      blockJson["backEdges"] = Order.BackEdges[ID];
+      blockJson["loopHeader"] = Order.LoopHeader[ID] != -1 ? json(Order.LoopHeader[ID]) : json(nullptr);
+      blockJson["loopDepth"] = Order.LoopDepth[ID];
+
+      blocksJson.push_back(blockJson);
+    }
+
+    funcJson["blocks"] = Options.SimplifyCFG ? simplifyBlocks(blocksJson) : std::move(blocksJson);
+    funcJson["variables"] = Variables.toJson();
+    funcJson["globalReads"] = GlobalReads;
+    funcJson["globalWrites"] = GlobalWrites;
+    funcJson["hash"] = hashRecord(funcJson, Body);
+    if (Options.OnFunction) {
+      Options.OnFunction(std::move(funcJson));
+    } else {
+      functions.push_back(std::move(funcJson));
+    }
+
+    return true;
+  }
+
+  json getFunctionsJson() const {
+    json result;
+    result["functions"] = functions;
+    result["globals"] = Globals.toJson(Context);
+    return result;
+  }
+
+private:
+  /// Add the shared globals among IDs (variable IDs of one statement) to
+  /// Accessed and to the file's global table.
+  void recordGlobalAccess(const VariableTable &Variables, const std::set<int> &IDs, std::set<int> &Accessed) {
+    for (int ID : IDs) {
+      const VarDecl *Var = Variables.getVariable(ID);
+      if (isSharedGlobal(Var)) {
+        Accessed.insert(ID);
+        Globals.add(Var);
+      }
+    }
+  }
+
+  /// Return type and parameters (name, declared and canonical type,
+  /// reference/pointer flags) of Func.
+  json exportSignature(const FunctionDecl *Func) const {
+    const PrintingPolicy &Policy = Context.getPrintingPolicy();
+    json SignatureJson;
+    SignatureJson["returnType"] = Func->getReturnType().getAsString(Policy);
+
+    json ParamsJson = json::array();
+    for (const ParmVarDecl *Param : Func->parameters()) {
+      QualType Type = Param->getType();
+      json ParamJson;
+      ParamJson["name"] = Param->getNameAsString();
+      ParamJson["type"] = Type.getAsString(Policy);
+      ParamJson["canonicalType"] = Type.getCanonicalType().getAsString(Policy);
+      ParamJson["isReference"] = Type->isReferenceType();
+      ParamJson["isPointer"] = Type.getNonReferenceType()->isPointerType();
+      ParamsJson.push_back(std::move(ParamJson));
+    }
+    SignatureJson["parameters"] = std::move(ParamsJson);
+    SignatureJson["isVariadic"] = Func->isVariadic();
+    return SignatureJson;
+  }
+
+  /// MD5 of Record (a function's record before its "hash" is set) and of the
+  /// declarations Body refers to, with their canonical types (see
+  /// ReferencedDeclCollector). Equal hashes mean an equal record: the CFG,
+  /// statement texts and ranges, def/use sets and access paths, call sites
+  /// with their resolved callees, and the signature. Because the record is
+  /// built from the expanded AST, edits elsewhere change the hash whenever
+  /// they change what the function exports. That includes macro definitions,
+  /// callee declarations and overload sets, and the types of the globals and
+  /// fields it uses. Positions are part of the record, so an edit above the
+  /// function that adds or removes lines (in another function, say) changes
+  /// the hash too. Edits below the function keep it.
+  std::string hashRecord(const json &Record, Stmt *Body) const {
+    llvm::MD5 Hash;
+    Hash.update(Record.dump());
+    ReferencedDeclCollector Referenced(Context);
+    Referenced.TraverseStmt(Body);
+    for (const std::string &Decl : Referenced.getDecls()) {
+      Hash.update(Decl);
+      Hash.update("\n");
+    }
+    llvm::MD5::MD5Result Digest;
+    Hash.final(Digest);
+    return Digest.digest().str().str();
+  }
+
+  /// MD5 of the tokens of Func's definition, each with its spelling and
+  /// position, followed by the definition each macro it names has at that
+  /// point of this translation unit (see hashMacro). Identifies what the
+  /// definition's text expands to here, but not the declarations it uses.
+  /// Keys the header function cache before any CFG is built; the exported
+  /// "hash" is hashRecord. Empty when the definition spans several files.
+  std::string hashTokens(const FunctionDecl *Func) const {
+    auto &SM = Context.getSourceManager();
+    const LangOptions &LangOpts = Context.getLangOpts();
+    SourceLocation Begin = SM.getExpansionLoc(Func->getBeginLoc());
+    SourceLocation End = SM.getExpansionLoc(Func->getEndLoc());
+    FileID File = SM.getFileID(Begin);
+    if (Begin.isInvalid() || End.isInvalid() || SM.getFileID(End) != File) {
+      return "";
+    }
+
+    bool Invalid = false;
+    StringRef Buffer = SM.getBufferData(File, &Invalid);
+    if (Invalid) {
+      return "";
+    }
+    unsigned EndOffset = SM.getFileOffset(End);
+    Lexer Lex(SM.getLocForStartOfFile(File), LangOpts, Buffer.begin(), Buffer.begin() + SM.getFileOffset(Begin),
+              Buffer.end());
+
+    llvm::MD5 Hash;
+    std::set<const IdentifierInfo *> Hashed;
+    Token Tok;
+    while (true) {
+      Lex.LexFromRawLexer(Tok);
+      if (Tok.is(tok::eof) || SM.getFileOffset(Tok.getLocation()) > EndOffset) {
+        break;
+      }
+      std::string Position = std::to_string(SM.getSpellingLineNumber(Tok.getLocation())) + ":" +
+                             std::to_string(SM.getSpellingColumnNumber(Tok.getLocation())) + " ";
+      Hash.update(Position);
+      Hash.update(Lexer::getSpelling(Tok, SM, LangOpts));
+      Hash.update("\n");
+      if (Tok.is(tok::raw_identifier)) {
+        hashMacro(PP.getIdentifierInfo(Tok.getRawIdentifier()), Tok.getLocation(), Hash, Hashed);
+      }
+    }
+    llvm::MD5::MD5Result Digest;
+    Hash.final(Digest);
+    return Digest.digest().str().str();
+  }
+
+  /// Add to Hash the definition Name has as a macro at Loc (parameters and
+  /// replacement tokens), then those of the macros it uses in turn. Names
+  /// that are not macros there add nothing; Hashed keeps each macro to one
+  /// visit per function, which also ends recursive definitions.
+  void hashMacro(const IdentifierInfo *Name, SourceLocation Loc, llvm::MD5 &Hash,
+                 std::set<const IdentifierInfo *> &Hashed) const {
+    if (!Name || !Name->hadMacroDefinition() || !Hashed.insert(Name).second) {
+      return;
+    }
+    const MacroInfo *Macro = PP.getMacroDefinitionAtLoc(Name, Loc).getMacroInfo();
+    if (!Macro) {
+      return;
+    }
+
+    Hash.update("#define " + Name->getName().str());
+    if (Macro->isFunctionLike()) {
+      Hash.update("(");
+      for (const IdentifierInfo *Param : Macro->params()) {
+        Hash.update(Param->getName());
+        Hash.update(",");
+      }
+      Hash.update(Macro->isVariadic() ? "...)" : ")");
+    }
+    for (const Token &Replacement : Macro->tokens()) {
+      Hash.update(" ");
+      Hash.update(PP.getSpelling(Replacement));
+    }
+    Hash.update("\n");
+    // Nested macros expand at the use site, so they resolve at Loc as well
+    for (const Token &Replacement : Macro->tokens()) {
+      hashMacro(Replacement.getIdentifierInfo(), Loc, Hash, Hashed);
+    }
+  }
+
+  /// Terminator of Block (statement class), its condition with the variables
+  /// the condition reads, and for two-way branches the successors taken when
+  /// the condition is true and false. Null for blocks without a terminator.
+  json exportTerminator(const CFGBlock &Block, const std::vector<int> &Enclosing, VariableTable &Variables) const {
+    const Stmt *Terminator = Block.getTerminatorStmt();
+    if (!Terminator) {
+      return nullptr;
+    }
+
+    json TermJson;
+    TermJson["kind"] = Terminator->getStmtClassName();
+
+    const auto *Cond = dyn_cast_or_null<Expr>(Block.getTerminatorCondition());
+    if (Cond) {
+      std::string CondStr;
+      llvm::raw_string_ostream Stream(CondStr);
+      Cond->printPretty(Stream, nullptr, Context.getPrintingPolicy());
+
+      json CondJson;
+      CondJson["text"] = Stream.str();
+      CondJson["statement"] = nullptr;
+      for (size_t Index = 0; Index < Block.size(); ++Index) {
+        auto StmtElem = Block[Index].getAs<CFGStmt>();
+        if (StmtElem && StmtElem->getStmt() == Cond) {
+          bool IsNested = !Enclosing.empty() && Enclosing[Index] != -1;
+          CondJson["statement"] = elementID(Block, IsNested ? Enclosing[Index] : Index);
+          break;
+        }
+      }
+
+      DefUseCollector DefUse(Variables);
+      DefUse.collect(Cond);
+      CondJson["uses"] = DefUse.usesJson();
+
+      // `if (DEBUG)`, `sizeof(T) > 8`, constexpr flags: the same evaluation
+      // Clang uses to prune the edge such a branch can never take
+      bool Value;
+      bool IsConstant = !Cond->isValueDependent() && !Cond->isTypeDependent() &&
+                        Cond->EvaluateAsBooleanCondition(Value, Context);
+      CondJson["constant"] = IsConstant ? json(Value) : json(nullptr);
+      TermJson["condition"] = std::move(CondJson);
+    } else {
+      TermJson["condition"] = nullptr;
+    }
+
+    // Clang lists the true edge of a two-way branch first; a null successor
+    // is an edge Clang proved infeasible
+    auto SuccessorID = [&Block](unsigned Index) -> json {
+      const CFGBlock *Succ = Block.succ_begin()[Index];
+      return Succ ? json(static_cast<int>(Succ->getBlockID())) : json(nullptr);
+    };
+    bool IsBranch = Cond && Block.succ_size() == 2 && !isa<SwitchStmt>(Terminator);
+    TermJson["trueSuccessor"] = IsBranch ? SuccessorID(0) : json(nullptr);
+    TermJson["falseSuccessor"] = IsBranch ? SuccessorID(1) : json(nullptr);
+    return TermJson;
+  }
+
+  /// Call-site record of Call, which is (part of) statement StatementID.
+  json exportCallSite(const CallExpr *Call, const ParentMap &Parents, VariableTable &Variables,
+                      const std::string &StatementID) {
+    auto &SM = Context.getSourceManager();
+    json CallJson;
+    CallJson["statement"] = StatementID;
+
+    const FunctionDecl *Callee = Call->getDirectCallee();
+    if (Callee) {
+      CallJson["callee"] = Callee->getQualifiedNameAsString();
+      CallJson["name"] = Callee->getNameAsString();
+      llvm::SmallString<128> USR;
+      if (!index::generateUSRForDecl(Callee, USR)) {
+        CallJson["usr"] = USR.str().str();
+      }
+    } else {
+      // Call through a function pointer or other callable expression
+      std::string CalleeText;
+      llvm::raw_string_ostream Stream(CalleeText);
+      Call->getCallee()->IgnoreParenImpCasts()->printPretty(Stream, nullptr, Context.getPrintingPolicy());
+      CallJson["callee"] = nullptr;
+      CallJson["name"] = Stream.str();
+    }
+
+    CallJson["range"]["start"]["line"] = SM.getSpellingLineNumber(Call->getBeginLoc());
+    CallJson["range"]["start"]["column"] = SM.getSpellingColumnNumber(Call->getBeginLoc());
+    CallJson["range"]["end"]["line"] = SM.getSpellingLineNumber(Call->getEndLoc());
+    CallJson["range"]["end"]["column"] = SM.getSpellingColumnNumber(Call->getEndLoc());
+
+    json ArgsJson = json::array();
+    for (unsigned I = 0; I < Call->getNumArgs(); ++I) {
+      const Expr *Arg = Call->getArg(I);
+      std::string ArgText;
+      llvm::raw_string_ostream Stream(ArgText);
+      Arg->printPretty(Stream, nullptr, Context.getPrintingPolicy());
+
+      DefUseCollector DefUse(Variables);
+      DefUse.collectArgument(Arg, Callee && I < Callee->getNumParams() ? Callee->getParamDecl(I)->getType() : QualType());
+
+      json ArgJson;
+      ArgJson["text"] = Stream.str();
+      ArgJson["type"] = Arg->getType().getAsString(Context.getPrintingPolicy());
+      ArgJson["defs"] = DefUse.defsJson();
+      ArgJson["uses"] = DefUse.usesJson();
+      ArgsJson.push_back(std::move(ArgJson));
+    }
+    CallJson["arguments"] = std::move(ArgsJson);
+
+    const Expr *Value = Call;
+    const Stmt *Consumer = getValueConsumer(Parents, Value);
+    CallJson["returnUsed"] = !Call->getType()->isVoidType() && isValueUsed(Consumer, Value);
+    const VarDecl *Assigned = getAssignedVariable(Consumer, Value);
+    CallJson["assignedTo"] = Assigned ? json(Variables.getID(Assigned)) : json(nullptr);
+    if (Options.Taint) {
+      CallJson["taint"] = exportTaintTags(Call, Callee, Assigned, Variables);
+    }
+    return CallJson;
+  }
+
+  /// Taint roles of Call per the registry spec: role, registry entry,
+  /// category, tainted or sanitized argument indices, and the variable that
+  /// receives the taint or sanitized value (null if none or not a variable).
+  json exportTaintTags(const CallExpr *Call, const FunctionDecl *Callee, const VarDecl *Assigned,
+                       VariableTable &Variables) const {
+    json TagsJson = json::array();
+    const std::vector<TaintSpec::Entry> *Entries = Callee ? Options.Taint->lookup(Callee) : nullptr;
+    if (!Entries) {
+      return TagsJson;
+    }
+
+    for (const TaintSpec::Entry &Entry : *Entries) {
+      const VarDecl *Target = nullptr;
+      if (Entry.Target == TaintSpec::ReturnValue) {
+        Target = Assigned;
+      } else if (Entry.Target >= 0 && static_cast<unsigned>(Entry.Target) < Call->getNumArgs()) {
+        // The buffer or object written through the argument: &x, buf, p->buf
+        const Expr *Arg = Call->getArg(Entry.Target)->IgnoreParenImpCasts();
+        if (const auto *AddrOf = dyn_cast<UnaryOperator>(Arg); AddrOf && AddrOf->getOpcode() == UO_AddrOf) {
+          Arg = AddrOf->getSubExpr();
+        }
+        json Steps;
+        getAccessPath(Arg, Context, 0, Target, Steps);
+      }
+
+      json TagJson;
+      TagJson["role"] = Entry.Role;
+      TagJson["entry"] = Entry.Name;
+      TagJson["category"] = Entry.Category;
+      TagJson["arguments"] = Entry.Arguments;
+      TagJson["target"] = Target ? json(Variables.getID(Target)) : json(nullptr);
+      TagsJson.push_back(std::move(TagJson));
+    }
+    return TagsJson;
+  }
+
+  /// Whether Func passes the --function and --lines filters of Options.
+  bool isSelected(const FunctionDecl *Func) const {
+    // Line ranges refer to the main file
+    if (Options.Lines && Context.getSourceManager().isInMainFile(Func->getLocation())) {
+      auto &SM = Context.getSourceManager();
+      unsigned FirstLine = SM.getExpansionLineNumber(Func->getBeginLoc());
+      unsigned LastLine = SM.getExpansionLineNumber(Func->getEndLoc());
+      if (LastLine < Options.Lines->first || FirstLine > Options.Lines->second) {
+        return false;
+      }
+    }
+
+    if (Options.Functions.empty()) {
+      return true;
+    }
+    std::string QualifiedName = Func->getQualifiedNameAsString();
+    std::string Name = Func->getNameAsString();
+    llvm::SmallString<128> USR;
+    bool HaveUSR = !index::generateUSRForDecl(Func, USR);
+    for (const std::string &Selector : Options.Functions) {
+      if (Selector == QualifiedName || Selector == Name || (HaveUSR && Selector == USR.str())) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  ASTContext &Context;
+  Preprocessor &PP;
+  const ExportOptions &Options;
+  json functions = json::array();
+  GlobalTable Globals;
+};
+
+class CFGExporterASTConsumer : public ASTConsumer {
+public:
+  CFGExporterASTConsumer(ASTContext &Context, Preprocessor &PP, const ExportOptions &Options, json &Result)
+      : Visitor(Context, PP, Options), SM(Context.getSourceManager()), Options(Options), Result(Result) {}
+
+  // Remember top-level declarations as they are parsed, so the traversal
+  // never has to walk the whole translation unit
+  bool HandleTopLevelDecl(DeclGroupRef Group) override {
+    TopLevelDecls.insert(TopLevelDecls.end(), Group.begin(), Group.end());
+    return true;
+  }
+
+  bool shouldSkipFunctionBody(Decl *D) override {
+    return Options.SkipHeaderFunctionBodies && !SM.isInMainFile(D->getLocation()) &&
+           !isExportedHeader(SM, D->getLocation(), Options);
+  }
+
+  void HandleTranslationUnit(ASTContext &Context) override {
+    traverseMainFileDecls(Context, Visitor, TopLevelDecls, Options);
+    Result = Visitor.getFunctionsJson();
+  }
+
+private:
+  CFGExporterVisitor Visitor;
+  const SourceManager &SM;
+  const ExportOptions &Options;
+  json &Result;
+  std::vector<Decl *> TopLevelDecls;
+};
+
+class CFGExporterFrontendAction : public ASTFrontendAction {
+public:
+  CFGExporterFrontendAction(const ExportOptions &Options, json &Result)
+      : Options(Options), Result(Result) {}
+
+  std::unique_ptr<ASTConsumer> CreateASTConsumer(CompilerInstance &CI, StringRef InFile) override {
+    // Lets the parser ask the consumer (shouldSkipFunctionBody) per function
+    CI.getFrontendOpts().SkipFunctionBodies = Options.SkipHeaderFunctionBodies;
+    return std::make_unique<CFGExporterASTConsumer>(CI.getASTContext(), CI.getPreprocessor(), Options, Result);
+  }
+
+private:
+  const ExportOptions &Options;
+  json &Result;
+};
+
+/**
+ * Stat cache shared by every request handled by one exporter process.
+ *
+ * Header search issues a stat() (mostly failing ones) for every include
+ * directory and every #include, which dominates the cost of small files that
+ * include the STL. Only paths below system include directories are cached:
+ * those do not change during an editor session, while project sources and
+ * headers may be edited between two requests and are always stat'ed afresh.
+ */
+class SessionStatCacheFS : public llvm::vfs::ProxyFileSystem {
+public:
+  explicit SessionStatCacheFS(llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> FS)
+      : ProxyFileSystem(std::move(FS)) {}
+
+  /// Record the system include directories named on a compiler command line.
+  void addSystemDirectories(const std::vector<std::string> &CommandLine) {
+    static const std::vector<std::string> Prefixes = {"-isystem", "-isysroot", "-resource-dir"};
+    for (size_t i = 0; i < CommandLine.size(); ++i) {
+      for (const std::string &Prefix : Prefixes) {
+        if (CommandLine[i].compare(0, Prefix.size(), Prefix) != 0) {
+          continue;
+        }
+        std::string Dir = CommandLine[i].substr(Prefix.size());
+        if (!Dir.empty() && Dir[0] == '=') {
+          Dir.erase(0, 1);
+        }
+        if (Dir.empty() && i + 1 < CommandLine.size()) {
+          Dir = CommandLine[i + 1];
+        }
+        if (!Dir.empty()) {
+          SystemDirs.insert(Dir);
+        }
+      }
+    }
+  }
+
+  llvm::ErrorOr<llvm::vfs::Status> status(const llvm::Twine &Path) override {
+    std::string Key = Path.str();
+    if (!isSystemPath(Key)) {
+      return ProxyFileSystem::status(Path);
+    }
+
+    auto It = StatCache.find(Key);
+    if (It != StatCache.end()) {
+      return It->second;
+    }
+    llvm::ErrorOr<llvm::vfs::Status> Result = ProxyFileSystem::status(Path);
+    StatCache.insert({Key, Result});
+    return Result;
+  }
+
+  llvm::ErrorOr<std::unique_ptr<llvm::vfs::File>> openFileForRead(const llvm::Twine &Path) override {
+    std::string Key = Path.str();
+    if (!isSystemPath(Key)) {
+      return ProxyFileSystem::openFileForRead(Path);
+    }
+
+    // FileManager opens candidate headers instead of stat'ing them, so the
+    // failed lookups of header search show up here rather than in status().
+    auto It = MissingFiles.find(Key);
+    if (It != MissingFiles.end()) {
+      return It->second;
+    }
+    auto Result = ProxyFileSystem::openFileForRead(Path);
+    if (!Result) {
+      MissingFiles.insert({Key, Result.getError()});
+    }
+    return Result;
+  }
+
+private:
+  bool isSystemPath(const std::string &Path) const {
+    for (const std::string &Dir : SystemDirs) {
+      if (Path.compare(0, Dir.size(), Dir) == 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  std::set<std::string> SystemDirs;
+  std::map<std::string, llvm::ErrorOr<llvm::vfs::Status>> StatCache;
+  std::map<std::string, std::error_code> MissingFiles;
+};
+
+/**
+ * Compiler state that outlives a single export.
+ *
+ * The one-shot mode creates a session for exactly one file; --serve keeps it
+ * alive for the whole process so consecutive requests reuse the loaded
+ * libraries, the PCH container operations and the system header stat cache.
+ */
+class ExporterSession {
+public:
+  /**
+   * @param DefaultArgs - Compiler arguments added to every command line
+   * @param IsolatedWorkingDirectory - Give the session its own working
+   *        directory instead of the process one, so sessions on different
+   *        threads can compile commands from different directories
+   */
+  explicit ExporterSession(std::vector<std::string> DefaultArgs, bool IsolatedWorkingDirectory = false)
+      : DefaultArgs(std::move(DefaultArgs)),
+        StatCache(new SessionStatCacheFS(
+            IsolatedWorkingDirectory
+                ? llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem>(llvm::vfs::createPhysicalFileSystem().release())
+                : llvm::vfs::getRealFileSystem())),
+        PCHContainerOps(std::make_shared<PCHContainerOperations>()) {}
+
+  /**
+   * Build the AST of SourceFile and export the CFG of every function in it.
+   *
+   * Like buildASTFromCodeWithArgs, a translation unit with compile errors
+   * still produces output (clang recovers with <recovery-expr> nodes); only
+   * a failure to produce an AST at all is reported through Error.
+   */
+  bool exportFile(const std::string &SourceFile, const std::vector<std::string> &ExtraArgs,
+                  const ExportOptions &Options, json &Result, std::string &Error) {
+    return runInvocation(buildCommandLine(SourceFile, ExtraArgs), "", SourceFile, Options, Result, Error);
+  }
+
+  /**
+   * Export a translation unit using its entry from a compilation database.
+   *
+   * The recorded compiler command is turned into a syntax-only run (output
+   * and dependency-file flags removed) and DefaultArgs are appended, so the
+   * per-file include paths and defines from the build are honoured.
+   */
+  bool exportCommand(const CompileCommand &Command, const ExportOptions &Options, json &Result,
+                     std::string &Error) {
+    ArgumentsAdjuster Adjuster = combineAdjusters(
+        combineAdjusters(getClangStripOutputAdjuster(), getClangStripDependencyFileAdjuster()),
+        combineAdjusters(getClangSyntaxOnlyAdjuster(),
+                         getInsertArgumentAdjuster(DefaultArgs, ArgumentInsertPosition::END)));
+    std::vector<std::string> CommandLine = Adjuster(Command.CommandLine, Command.Filename);
+    return runInvocation(CommandLine, Command.Directory, Command.Filename, Options, Result, Error);
+  }
+
+  /**
+   * Export SourceFile from an ASTUnit that is kept alive between requests.
+   *
+   * The first request parses the file and precompiles its preamble (the
+   * #include block at the top of the file). Later requests call
+   * ASTUnit::Reparse, which reuses that preamble and only re-parses the
+   * main-file body, until the preamble region or one of the headers it
+   * depends on changes. Used for keystroke-mode updates of open editors.
+   * Unsaved contents in Options are remapped over the file for this parse
+   * only; a later request without contents reads the file from disk again.
+   */
+  bool exportOpenFile(const std::string &SourceFile, const std::vector<std::string> &ExtraArgs,
+                      const ExportOptions &Options, json &Result, std::string &Error) {
+    std::vector<std::string> CommandLine = buildCommandLine(SourceFile, ExtraArgs);
+
+    auto It = OpenUnits.find(SourceFile);
+    if (It != OpenUnits.end() && (It->second.CommandLine != CommandLine ||
+                                  It->second.SkipHeaderFunctionBodies != Options.SkipHeaderFunctionBodies)) {
+      // Different flags invalidate the preamble; start over
+      closeFile(SourceFile);
+      It = OpenUnits.end();
+    }
+
+    if (It == OpenUnits.end()) {
+      std::unique_ptr<ASTUnit> Unit =
+          loadUnit(CommandLine, remapMainFile(SourceFile, Options), Options.SkipHeaderFunctionBodies);
+      if (!Unit) {
+        Error = "Failed to build AST for " + SourceFile;
+        return false;
+      }
+      evictOldestUnit();
+      It = OpenUnits.emplace(SourceFile, OpenUnit{CommandLine, Options.SkipHeaderFunctionBodies, std::move(Unit)})
+               .first;
+    } else if (It->second.Unit->Reparse(PCHContainerOps, remapMainFile(SourceFile, Options))) {
+      closeFile(SourceFile);
+      Error = "Failed to reparse " + SourceFile;
+      return false;
+    }
+
+    touchUnit(SourceFile);
+
+    ASTUnit &Unit = *It->second.Unit;
+    CFGExporterVisitor Visitor(Unit.getASTContext(), Unit.getPreprocessor(), Options);
+    traverseMainFileDecls(Unit.getASTContext(), Visitor,
+                          std::vector<Decl *>(Unit.top_level_begin(), Unit.top_level_end()), Options);
+    Result = Visitor.getFunctionsJson();
+    return true;
+  }
+
+  /// Drop the ASTUnit (and its preamble) kept for SourceFile, if any.
+  void closeFile(const std::string &SourceFile) {
+    OpenUnits.erase(SourceFile);
+    UnitOrder.remove(SourceFile);
+  }
+
+private:
+  struct OpenUnit {
+    std::vector<std::string> CommandLine;
+    bool SkipHeaderFunctionBodies;
+    std::unique_ptr<ASTUnit> Unit;
+  };
+
+  // Each preamble holds the parsed headers of one file; bound the memory
+  // kept for editors the client forgot to close
+  static constexpr size_t MaxOpenUnits = 8;
+
+  bool runInvocation(const std::vector<std::string> &CommandLine, const std::string &WorkingDir,
+                     const std::string &SourceFile, const ExportOptions &Options, json &Result,
+                     std::string &Error) {
+    StatCache->addSystemDirectories(CommandLine);
+
+    FileSystemOptions FSOpts;
+    if (!WorkingDir.empty()) {
+      FSOpts.WorkingDir = WorkingDir;
+      StatCache->setCurrentWorkingDirectory(WorkingDir);
+    }
+
+    // Unsaved main-file contents shadow the file on disk through an overlay
+    llvm::IntrusiveRefCntPtr<llvm::vfs::FileSystem> FS = StatCache;
+    if (Options.MainFileContents) {
+      llvm::SmallString<256> MainFilePath(SourceFile);
+      if (WorkingDir.empty()) {
+        llvm::sys::fs::make_absolute(MainFilePath);
+      } else {
+        llvm::sys::fs::make_absolute(WorkingDir, MainFilePath);
+      }
+      llvm::IntrusiveRefCntPtr<llvm::vfs::InMemoryFileSystem> MainFile(new llvm::vfs::InMemoryFileSystem);
+      MainFile->addFile(MainFilePath, /*ModificationTime=*/0,
+                        llvm::MemoryBuffer::getMemBufferCopy(*Options.MainFileContents, MainFilePath));
+      llvm::IntrusiveRefCntPtr<llvm::vfs::OverlayFileSystem> Overlay(new llvm::vfs::OverlayFileSystem(StatCache));
+      Overlay->pushOverlay(MainFile);
+      FS = Overlay;
+    }
+
+    // A fresh FileManager per request: the main file may have changed since
+    // the previous request. The stats worth keeping live in StatCache below it.
+    llvm::IntrusiveRefCntPtr<FileManager> Files(new FileManager(FSOpts, FS));
+
+    Result = json();
+    ToolInvocation Invocation(CommandLine, std::make_unique<CFGExporterFrontendAction>(Options, Result),
+                              Files.get(), PCHContainerOps);
+    Invocation.run();
+
+    if (!Result.contains("functions")) {
+      Error = "Failed to build AST for " + SourceFile;
+      return false;
+    }
+    return true;
+  }
+
+  std::vector<std::string> buildCommandLine(const std::string &SourceFile,
+                                            const std::vector<std::string> &ExtraArgs) const {
+    std::vector<std::string> CommandLine = {"cfg-exporter", "-fsyntax-only"};
+    CommandLine.insert(CommandLine.end(), DefaultArgs.begin(), DefaultArgs.end());
+    CommandLine.insert(CommandLine.end(), ExtraArgs.begin(), ExtraArgs.end());
+    CommandLine.push_back(SourceFile);
+    return CommandLine;
+  }
+
+  /// Remapped-file list for ASTUnit; the unit takes ownership of the buffers.
+  static std::vector<ASTUnit::RemappedFile> remapMainFile(const std::string &SourceFile,
+                                                          const ExportOptions &Options) {
+    std::vector<ASTUnit::RemappedFile> Remapped;
+    if (Options.MainFileContents) {
+      Remapped.emplace_back(SourceFile,
+                            llvm::MemoryBuffer::getMemBufferCopy(*Options.MainFileContents, SourceFile).release());
+    }
+    return Remapped;
+  }
+
+  std::unique_ptr<ASTUnit> loadUnit(const std::vector<std::string> &CommandLine,
+                                    llvm::ArrayRef<ASTUnit::RemappedFile> RemappedFiles,
+                                    bool SkipHeaderFunctionBodies) {
+    std::vector<const char *> Argv;
+    for (const std::string &Arg : CommandLine) {
+      Argv.push_back(Arg.c_str());
+    }
+
+    IntrusiveRefCntPtr<DiagnosticsEngine> Diags =
+        CompilerInstance::createDiagnostics(new DiagnosticOptions());
+
+    // LLVM 18 parameter list; the preamble is written to the system temp
+    // directory, as in one-shot clang tools
+    return std::unique_ptr<ASTUnit>(ASTUnit::LoadFromCommandLine(
+        Argv.data(), Argv.data() + Argv.size(), PCHContainerOps, Diags,
+        /*ResourceFilesPath=*/"", /*StorePreamblesInMemory=*/false, /*PreambleStoragePath=*/"",
+        /*OnlyLocalDecls=*/false, CaptureDiagsKind::None,
+        RemappedFiles, /*RemappedFilesKeepOriginalName=*/true,
+        /*PrecompilePreambleAfterNParses=*/1, TU_Complete,
+        /*CacheCodeCompletionResults=*/false,
+        /*IncludeBriefCommentsInCodeCompletion=*/false,
+        /*AllowPCHWithCompilerErrors=*/true,
+        // The preamble is the #include block: skipping its bodies skips header bodies
+        SkipHeaderFunctionBodies ? SkipFunctionBodiesScope::Preamble : SkipFunctionBodiesScope::None,
+        /*SingleFileParse=*/false, /*UserFilesAreVolatile=*/true));
+  }
+
+  void touchUnit(const std::string &SourceFile) {
+    UnitOrder.remove(SourceFile);
+    UnitOrder.push_back(SourceFile);
+  }
+
+  void evictOldestUnit() {
+    while (OpenUnits.size() >= MaxOpenUnits && !UnitOrder.empty()) {
+      closeFile(UnitOrder.front());
+    }
+  }
+
+  std::vector<std::string> DefaultArgs;
+  llvm::IntrusiveRefCntPtr<SessionStatCacheFS> StatCache;
+  std::shared_ptr<PCHContainerOperations> PCHContainerOps;
+
+  std::map<std::string, OpenUnit> OpenUnits;
+  std::list<std::string> UnitOrder;  // least recently used first
+};
+
+/// Wire format of everything the exporter writes to stdout (--format=)
+enum class OutputFormat { JSON, MessagePack, CBOR };
+
+static bool parseOutputFormat(const std::string &Name, OutputFormat &Format) {
+  if (Name == "json") {
+    Format = OutputFormat::JSON;
+  } else if (Name == "msgpack") {
+    Format = OutputFormat::MessagePack;
+  } else if (Name == "cbor") {
+    Format = OutputFormat::CBOR;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Serialize one output value. JSON is compact text; the binary formats are
+ * self-delimiting, so consecutive values need no separator.
+ */
+static std::string encodeOutput(const json &Value, OutputFormat Format) {
+  std::vector<std::uint8_t> Bytes;
+  switch (Format) {
+  case OutputFormat::JSON:
+    return Value.dump();
+  case OutputFormat::MessagePack:
+    Bytes = json::to_msgpack(Value);
+    break;
+  case OutputFormat::CBOR:
+    Bytes = json::to_cbor(Value);
+    break;
+  }
+  return std::string(Bytes.begin(), Bytes.end());
+}
+
+/**
+ * Write one top-level output record to stdout: a JSON line, or a bare
+ * MessagePack/CBOR value.
+ */
+static void writeRecord(const json &Value, OutputFormat Format) {
+  llvm::outs() << encodeOutput(Value, Format);
+  if (Format == OutputFormat::JSON) {
+    llvm::outs() << "\n";
+  }
+  llvm::outs().flush();
+}
+
+/**
+ * String table of one output stream (--intern-strings).
+ *
+ * File paths, statement and argument texts, names and types repeat across
+ * the records of a large export (every function names its file, and
+ * generated code repeats the same statements thousands of times). Interning
+ * replaces each such string by its index in a table that grows with the
+ * stream: every record carries the strings it adds, in order, as
+ * "strings": [...], so a reader appends them before resolving the record.
+ * A stand-alone document (or server response) is its own stream, and its
+ * "strings" is the whole table.
+ */
+class StringTable {
+public:
+  /// Replace the strings of interned fields anywhere in Record by table
+  /// indices and attach the strings this adds to the table.
+  void internRecord(json &Record) {
+    size_t First = Strings.size();
+    internFields(Record);
+    if (Strings.size() > First) {
+      Record["strings"] = std::vector<std::string>(Strings.begin() + First, Strings.end());
+    }
+  }
+
+private:
+  /// Fields holding free-form text; kinds, roles and other short enum-like
+  /// values stay inline.
+  static bool isInternedField(const std::string &Key) {
+    static const std::set<std::string> Fields = {"file", "name",          "qualifiedName", "callee",    "usr",
+                                                 "text", "type",          "canonicalType", "returnType"};
+    return Fields.count(Key) != 0;
+  }
+
+  void internFields(json &Value) {
+    if (Value.is_array()) {
+      for (json &Element : Value) {
+        internFields(Element);
+      }
+      return;
+    }
+    if (!Value.is_object()) {
+      return;
+    }
+    for (auto It = Value.begin(); It != Value.end(); ++It) {
+      if (It.value().is_string() && isInternedField(It.key())) {
+        It.value() = intern(It.value().get_ref<const std::string &>());
+      } else {
+        internFields(It.value());
+      }
+    }
+  }
+
+  unsigned intern(const std::string &String) {
+    auto Inserted = Index.try_emplace(String, static_cast<unsigned>(Strings.size()));
+    if (Inserted.second) {
+      Strings.push_back(String);
+    }
+    return Inserted.first->second;
+  }
+
+  llvm::StringMap<unsigned> Index;
+  std::vector<std::string> Strings;
+};
+
+/**
+ * Encode a result straight into a new temporary file, without building the
+ * encoded bytes in memory first. The caller hands only the path and length to
+ * the reader, which loads the file in one piece instead of through the stdout
+ * pipe, and deletes it afterwards.
+ */
+static bool writeResultFile(const json &Result, OutputFormat Format, std::string &Path, std::size_t &Length,
+                            std::string &Error) {
+  llvm::SmallString<256> TempPath;
+  const char *Suffix = Format == OutputFormat::JSON ? "json" : Format == OutputFormat::CBOR ? "cbor" : "msgpack";
+  if (std::error_code EC = llvm::sys::fs::createTemporaryFile("cfg-exporter", Suffix, TempPath)) {
+    Error = "Could not create result file: " + EC.message();
+    return false;
+  }
+
+  std::ofstream Out(TempPath.c_str(), std::ios::binary | std::ios::trunc);
+  switch (Format) {
+  case OutputFormat::JSON:
+    Out << Result;
+    break;
+  case OutputFormat::MessagePack:
+    json::to_msgpack(Result, Out);
+    break;
+  case OutputFormat::CBOR:
+    json::to_cbor(Result, Out);
+    break;
+  }
+  Length = static_cast<std::size_t>(Out.tellp());
+  Out.close();
+  if (!Out) {
+    Error = "Could not write result file " + TempPath.str().str();
+    llvm::sys::fs::remove(TempPath);
+    return false;
+  }
+
+  Path = std::string(TempPath.str());
+  return true;
+}
 
-  bool VisitFunctionDecl(FunctionDecl *Func) {
-    if (!Func->hasBody()) {
-      return true;
+/**
+ * Switch stdout to binary mode; frame lengths and MessagePack/CBOR payloads
+ * are byte counts, so CRLF translation must stay out of the stream.
+ */
+static void setBinaryStdout() {
+#ifdef _WIN32
+  _setmode(_fileno(stdout), _O_BINARY);
+#endif
+}
+
+/**
+ * Read one request frame from the --serve input stream.
+ *
+ * Frames use the same header framing as the Language Server Protocol:
+ *   Content-Length: <bytes>\r\n
+ *   \r\n
+ *   <payload>
+ *
+ * @returns false on end of input or a malformed header
+ */
+static bool readFrame(std::istream &In, std::string &Payload) {
+  static const std::string LengthHeader = "Content-Length:";
+  size_t ContentLength = 0;
+  bool HaveLength = false;
+
+  std::string Line;
+  while (std::getline(In, Line)) {
+    if (!Line.empty() && Line.back() == '\r') {
+      Line.pop_back();
+    }
+    if (Line.empty()) {
+      if (HaveLength) {
+        break;
+      }
+      continue;
     }
+    if (Line.compare(0, LengthHeader.size(), LengthHeader) == 0) {
+      try {
+        ContentLength = std::stoul(Line.substr(LengthHeader.size()));
+        HaveLength = true;
+      } catch (const std::exception &) {
+        return false;
+      }
+    }
+  }
 
-    Stmt *Body = Func->getBody();
-    auto &SM = Context.getSourceManager();
+  if (!HaveLength) {
+    return false;
+  }
 
-    // Skip functions not in main file
-    if (!SM.isInMainFile(Func->getLocation())) {
-      return true;
+  Payload.resize(ContentLength);
+  In.read(&Payload[0], static_cast<std::streamsize>(ContentLength));
+  return static_cast<size_t>(In.gcount()) == ContentLength;
+}
+
+static void writeFrame(const std::string &Payload) {
+  llvm::outs() << "Content-Length: " << Payload.size() << "\r\n\r\n" << Payload;
+  llvm::outs().flush();
+}
+
+static void writeError(const json &Id, const std::string &Message, OutputFormat Format) {
+  json Response;
+  Response["id"] = Id;
+  Response["error"]["message"] = Message;
+  writeFrame(encodeOutput(Response, Format));
+}
+
+/**
+ * Long-lived request loop used by ClangASTParser.
+ *
+ * Requests are JSON objects of the form
+ *   { "id": 1, "method": "export", "params": { "file": "...", "args": [...] } }
+ * and are answered in order with { "id": 1, "result": { "functions": [...] } }
+ * or { "id": 1, "error": { "message": "..." } }. A "shutdown" request ends
+ * the loop, as does closing stdin. Requests are always JSON; response frames
+ * carry Format (JSON, MessagePack or CBOR).
+ *
+ * With "keepAlive": true in the params, the file's AST and precompiled
+ * preamble stay in memory for the next export of the same file, until a
+ * { "method": "close", "params": { "file": "..." } } request drops them.
+ *
+ * "functions": [<qualified-name|USR>...] and "lines": "<start>-<end>" limit
+ * the export to matching functions; only their CFGs are built.
+ *
+ * "skipHeaderBodies": true skips parsing function bodies outside the main file
+ * (for keepAlive files: inside the precompiled preamble).
+ *
+ * "topLevelStatements": true emits one statement per source-level statement
+ * (see ExportOptions::TopLevelStatements).
+ *
+ * "simplifyCFG": true exports simplified CFGs (see ExportOptions::SimplifyCFG).
+ *
+ * "accessPathDepth": N limits access paths to N steps, 0 omits them (see
+ * ExportOptions::AccessPathDepth).
+ *
+ * "taintSpec": "<file>" tags call sites with the taint roles of a registry
+ * spec (see TaintSpec); specs are kept per path and reloaded when the file's
+ * modification time or size changes.
+ *
+ * "internStrings": true interns repeated strings (see StringTable); each
+ * request is one stream, spanning its function frames and its result.
+ *
+ * A "contents" string in the export params is analyzed in place of the file
+ * on disk (unsaved editor buffer); "file" still names it.
+ *
+ * With "resultFile": true, the encoded result is written to a temporary file
+ * and the response is { "id": 1, "result": { "path": "...", "length": N } };
+ * the client owns (and deletes) the file.
+ */
+static int runServer(const std::vector<std::string> &DefaultArgs, const ExportOptions &BaseOptions,
+                     OutputFormat Format, bool InternStrings) {
+#ifdef _WIN32
+  // Frame lengths are byte counts; keep CRLF translation out of the stream
+  _setmode(_fileno(stdin), _O_BINARY);
+#endif
+  setBinaryStdout();
+
+  ExporterSession Session(DefaultArgs);
+  // Loaded taint specs by path, with the status of the file they came from
+  struct LoadedTaintSpec {
+    std::shared_ptr<const TaintSpec> Spec;
+    llvm::sys::TimePoint<> ModificationTime;
+    uint64_t Size = 0;
+  };
+  std::map<std::string, LoadedTaintSpec> TaintSpecs;
+  std::string Payload;
+
+  while (readFrame(std::cin, Payload)) {
+    json Request = json::parse(Payload, nullptr, /*allow_exceptions=*/false);
+    if (Request.is_discarded() || !Request.is_object()) {
+      writeError(nullptr, "Malformed request", Format);
+      continue;
     }
 
-    std::unique_ptr<CFG> cfg = CFG::buildCFG(Func, Body, &Context, CFG::BuildOptions());
-    if (!cfg) {
-      return true;
+    json Id = Request.value("id", json());
+    std::string Method = Request.value("method", "export");
+    json Params = Request.value("params", json::object());
+
+    if (Method == "shutdown") {
+      json Response;
+      Response["id"] = Id;
+      Response["result"] = nullptr;
+      writeFrame(encodeOutput(Response, Format));
+      break;
     }
 
-    json funcJson;
-    funcJson["name"] = Func->getNameInfo().getName().getAsString();
+    if (Method != "export" && Method != "close") {
+      writeError(Id, "Unknown method: " + Method, Format);
+      continue;
+    }
 
-    SourceLocation Loc = Func->getBeginLoc();
-    if (Loc.isValid()) {
-      funcJson["range"]["start"]["line"] = SM.getSpellingLineNumber(Loc);
-      funcJson["range"]["start"]["column"] = SM.getSpellingColumnNumber(Loc);
-      funcJson["file"] = SM.getFilename(Loc).str();
+    std::string SourceFile = Params.value("file", "");
+    std::vector<std::string> ExtraArgs = Params.value("args", std::vector<std::string>());
+    if (SourceFile.empty()) {
+      writeError(Id, "Missing params.file", Format);
+      continue;
     }
 
-    json blocksJson = json::array();
+    if (Method == "close") {
+      Session.closeFile(SourceFile);
+      json Response;
+      Response["id"] = Id;
+      Response["result"] = nullptr;
+      writeFrame(encodeOutput(Response, Format));
+      continue;
+    }
 
-    for (const CFGBlock *Block : *cfg) {
-      json blockJson;
-      blockJson["id"] = static_cast<int>(Block->getBlockID());
-      bool isEntry = (Block == &cfg->getEntry());
-      bool isExit = Block->succ_empty();
-      blockJson["label"] = isEntry ? "Entry" : (isExit ? "Exit" : ("B" + std::to_string(Block->getBlockID())));
-      blockJson["isEntry"] = isEntry;
-      blockJson["isExit"] = isExit;
+    ExportOptions Options;
+    if (Params.contains("contents") && Params["contents"].is_string()) {
+      Options.MainFileContents = Params["contents"].get<std::string>();
+    }
+    Options.SkipHeaderFunctionBodies = Params.value("skipHeaderBodies", BaseOptions.SkipHeaderFunctionBodies);
+    Options.TopLevelStatements = Params.value("topLevelStatements", BaseOptions.TopLevelStatements);
+    Options.SimplifyCFG = Params.value("simplifyCFG", BaseOptions.SimplifyCFG);
+    Options.AccessPathDepth = BaseOptions.AccessPathDepth;
+    if (Params.contains("accessPathDepth")) {
+      if (!Params["accessPathDepth"].is_number_unsigned()) {
+        writeError(Id, "Invalid params.accessPathDepth (expected a number of steps)", Format);
+        continue;
+      }
+      Options.AccessPathDepth = Params["accessPathDepth"].get<unsigned>();
+    }
+    Options.Taint = BaseOptions.Taint;
+    if (Params.contains("taintSpec")) {
+      std::string SpecPath = Params.value("taintSpec", "");
+      // Clients send the same path with every request: reload edited specs
+      llvm::sys::fs::file_status Status;
+      if (std::error_code EC = llvm::sys::fs::status(SpecPath, Status)) {
+        writeError(Id, "Cannot read taint spec " + SpecPath + ": " + EC.message(), Format);
+        continue;
+      }
+      LoadedTaintSpec &Loaded = TaintSpecs[SpecPath];
+      if (!Loaded.Spec || Loaded.ModificationTime != Status.getLastModificationTime() ||
+          Loaded.Size != Status.getSize()) {
+        std::string Error;
+        Loaded.Spec = TaintSpec::load(SpecPath, Error);
+        if (!Loaded.Spec) {
+          TaintSpecs.erase(SpecPath);
+          writeError(Id, Error, Format);
+          continue;
+        }
+        Loaded.ModificationTime = Status.getLastModificationTime();
+        Loaded.Size = Status.getSize();
+      }
+      Options.Taint = Loaded.Spec;
+    }
+    Options.Functions = Params.value("functions", BaseOptions.Functions);
+    Options.Lines = BaseOptions.Lines;
+    if (Params.contains("lines")) {
+      std::pair<unsigned, unsigned> Range;
+      if (!Params["lines"].is_string() || !parseLineRange(Params["lines"].get<std::string>(), Range)) {
+        writeError(Id, "Invalid params.lines (expected \"<start>-<end>\")", Format);
+        continue;
+      }
+      Options.Lines = Range;
+    }
+    bool Intern = Params.value("internStrings", InternStrings);
+    StringTable Strings;
+    if (Params.value("stream", false)) {
+      // Each function goes out as its own frame before the final response
+      Options.OnFunction = [&Id, &Strings, Intern, Format](json &&Function) {
+        json Notification;
+        Notification["id"] = Id;
+        Notification["function"] = std::move(Function);
+        if (Intern) {
+          Strings.internRecord(Notification);
+        }
+        writeFrame(encodeOutput(Notification, Format));
+      };
+    }
 
-      json statementsJson = json::array();
+    json Result;
+    std::string Error;
+    bool KeepAlive = Params.value("keepAlive", false);
+    bool Exported = KeepAlive ? Session.exportOpenFile(SourceFile, ExtraArgs, Options, Result, Error)
+                              : Session.exportFile(SourceFile, ExtraArgs, Options, Result, Error);
+    if (!Exported) {
+      writeError(Id, Error, Format);
+      continue;
+    }
+    if (Intern) {
+      Strings.internRecord(Result);
+    }
 
-      for (const auto &Element : *Block) {
-        if (auto StmtElem = Element.getAs<CFGStmt>()) {
-          const Stmt *S = StmtElem->getStmt();
+    // Large results can bypass the pipe: the payload goes to a temporary
+    // file and the response carries only its path and length
+    if (Params.value("resultFile", false)) {
+      std::string Path;
+      std::size_t Length = 0;
+      if (!writeResultFile(Result, Format, Path, Length, Error)) {
+        writeError(Id, Error, Format);
+        continue;
+      }
+      Result = json::object();
+      Result["path"] = Path;
+      Result["length"] = Length;
+    }
 
-          std::string stmtStr;
-          llvm::raw_string_ostream stream(stmtStr);
-          S->printPretty(stream, nullptr, Context.getPrintingPolicy());
+    json Response;
+    Response["id"] = Id;
+    Response["result"] = std::move(Result);
+    writeFrame(encodeOutput(Response, Format));
+  }
 
-          json stmtJson;
-          stmtJson["text"] = stream.str();
+  return 0;
+}
 
-          auto BeginLoc = S->getBeginLoc();
-          auto EndLoc = S->getEndLoc();
+/**
+ * Batch mode: export many translation units on a pool of worker threads.
+ *
+ * Every worker owns an ExporterSession (FileManager, stat cache and working
+ * directory), so workers share no mutable compiler state. Each finished
+ * translation unit is written immediately as one compact JSON line,
+ *   { "file": "...", "functions": [...], "globals": [...] }  or  { "file": "...", "error": "..." }
+ * in completion order, so the reader can start on early results.
+ *
+ * With Stream set, every function is written as its own line as soon as its
+ * CFG is exported, and the translation unit is closed by a "done" line:
+ *   { "file": "...", "function": {...} } ... { "file": "...", "done": true, "globals": [...] }
+ * Lines of different files interleave when several workers are running.
+ *
+ * With a binary Format, every record is a MessagePack/CBOR value instead of a
+ * JSON line, with no separators in between.
+ *
+ * With a header function cache in BaseOptions, all workers share it: a
+ * function defined in a project header is exported (marked "header") in the
+ * record of whichever translation unit claims it first.
+ *
+ * With InternStrings, all records share one string table (see StringTable),
+ * so records are interned and encoded in output order, under the output lock.
+ */
+static int runBatch(const std::vector<CompileCommand> &Commands, unsigned Jobs,
+                    const std::vector<std::string> &DefaultArgs, const ExportOptions &BaseOptions,
+                    bool Stream, OutputFormat Format, bool InternStrings) {
+  std::atomic<size_t> Next(0);
+  std::mutex OutputMutex;
+  StringTable Strings;
 
-          stmtJson["range"]["start"]["line"] = SM.getSpellingLineNumber(BeginLoc);
-          stmtJson["range"]["start"]["column"] = SM.getSpellingColumnNumber(BeginLoc);
-          stmtJson["range"]["end"]["line"] = SM.getSpellingLineNumber(EndLoc);
-          stmtJson["range"]["end"]["column"] = SM.getSpellingColumnNumber(EndLoc);
+  auto WriteLine = [&OutputMutex, &Strings, Format, InternStrings](json &Record) {
+    std::string Line;
+    if (!InternStrings) {
+      Line = encodeOutput(Record, Format);
+    }
+    std::lock_guard<std::mutex> Lock(OutputMutex);
+    if (InternStrings) {
+      Strings.internRecord(Record);
+      Line = encodeOutput(Record, Format);
+    }
+    llvm::outs() << Line;
+    if (Format == OutputFormat::JSON) {
+      llvm::outs() << "\n";
+    }
+    llvm::outs().flush();
+  };
 
-          statementsJson.push_back(stmtJson);
-        }
+  auto Worker = [&]() {
+    ExporterSession Session(DefaultArgs, /*IsolatedWorkingDirectory=*/true);
+    for (size_t Index = Next++; Index < Commands.size(); Index = Next++) {
+      const CompileCommand &Command = Commands[Index];
+
+      ExportOptions Options = BaseOptions;
+      if (Stream) {
+        Options.OnFunction = [&](json &&Function) {
+          json Record;
+          Record["file"] = Command.Filename;
+          Record["function"] = std::move(Function);
+          WriteLine(Record);
+        };
       }
 
-      blockJson["statements"] = statementsJson;
+      json Record;
+      Record["file"] = Command.Filename;
 
-      json succJson = json::array();
-      for (auto SuccIt = Block->succ_begin(); SuccIt != Block->succ_end(); ++SuccIt) {
-        if (const CFGBlock *Succ = *SuccIt) {
-          succJson.push_back(static_cast<int>(Succ->getBlockID()));
-        }
+      json Result;
+      std::string Error;
+      if (!Session.exportCommand(Command, Options, Result, Error)) {
+        Record["error"] = Error;
+      } else if (Stream) {
+        Record["done"] = true;
+        Record["globals"] = std::move(Result["globals"]);
+      } else {
+        Record["functions"] = std::move(Result["functions"]);
+        Record["globals"] = std::move(Result["globals"]);
       }
-      blockJson["successors"] = succJson;
+      WriteLine(Record);
+    }
+  };
 
-      json predJson = json::array();
-      for (auto PredIt = Block->pred_begin(); PredIt != Block->pred_end(); ++PredIt) {
-        if (const CFGBlock *Pred = *PredIt) {
-          predJson.push_back(static_cast<int>(Pred->getBlockID()));
-        }
-      }
-      blockJson["predecessors"] = predJson;
+  Jobs = std::max(1u, std::min<unsigned>(Jobs, static_cast<unsigned>(Commands.size())));
+  std::vector<std::thread> Workers;
+  for (unsigned i = 0; i < Jobs; ++i) {
+    Workers.emplace_back(Worker);
+  }
+  for (std::thread &T : Workers) {
+    T.join();
+  }
 
-      blocksJson.push_back(blockJson);
+  return 0;
+}
+
+/**
+ * Collect one compile command per batch input file.
+ *
+ * Files found in the compilation database use their recorded command (the
+ * first one if a file is built several times); other files are compiled with
+ * the default flags, like the single-file mode. Without input files, every
+ * file of the database is exported.
+ */
+static bool collectBatchCommands(const std::string &CompileCommandsPath, std::vector<std::string> InputFiles,
+                                 std::vector<CompileCommand> &Commands) {
+  std::unique_ptr<CompilationDatabase> Database;
+  if (!CompileCommandsPath.empty()) {
+    std::string ErrorMessage;
+    if (llvm::sys::fs::is_directory(CompileCommandsPath)) {
+      Database = CompilationDatabase::loadFromDirectory(CompileCommandsPath, ErrorMessage);
+    } else {
+      Database = JSONCompilationDatabase::loadFromFile(CompileCommandsPath, ErrorMessage,
+                                                       JSONCommandLineSyntax::AutoDetect);
+    }
+    if (!Database) {
+      llvm::errs() << "Error: Could not load compilation database: " << ErrorMessage << "\n";
+      return false;
     }
+    if (InputFiles.empty()) {
+      InputFiles = Database->getAllFiles();
+    }
+  }
 
-    funcJson["blocks"] = blocksJson;
-    functions.push_back(funcJson);
+  for (const std::string &File : InputFiles) {
+    std::vector<CompileCommand> FileCommands;
+    if (Database) {
+      FileCommands = Database->getCompileCommands(File);
+    }
 
-    return true;
+    CompileCommand Command;
+    if (FileCommands.empty()) {
+      Command.Filename = File;
+      Command.CommandLine = {"cfg-exporter", "-std=c++17", File};
+    } else {
+      Command = FileCommands.front();
+    }
+
+    // Report results under an absolute path, whatever the database recorded
+    llvm::SmallString<256> AbsolutePath(Command.Filename);
+    if (Command.Directory.empty()) {
+      llvm::sys::fs::make_absolute(AbsolutePath);
+    } else {
+      llvm::sys::fs::make_absolute(Command.Directory, AbsolutePath);
+    }
+    llvm::sys::path::remove_dots(AbsolutePath, /*remove_dot_dot=*/true);
+    Command.Filename = std::string(AbsolutePath.str());
+    Commands.push_back(std::move(Command));
   }
 
-  json getFunctionsJson() const {
-    json result;
-    result["functions"] = functions;
-    return result;
+  return true;
+}
+
+/**
+ * Locate the clang driver whose toolchain layout the exporter should mimic.
+ *
+ * Prefers the clang of the LLVM installation the exporter was built against
+ * (its builtin headers match the linked libclang), then clang++ from PATH.
+ */
+static std::string findClangExecutable() {
+#ifdef CFG_EXPORTER_LLVM_TOOLS_DIR
+  for (const char *Name : {"clang++", "clang"}) {
+    llvm::SmallString<256> Candidate(CFG_EXPORTER_LLVM_TOOLS_DIR);
+    llvm::sys::path::append(Candidate, Name);
+    if (llvm::sys::fs::can_execute(Candidate)) {
+      return std::string(Candidate.str());
+    }
   }
+#endif
+  for (const char *Name : {"clang++", "clang"}) {
+    if (llvm::ErrorOr<std::string> Found = llvm::sys::findProgramByName(Name)) {
+      return *Found;
+    }
+  }
+  return "clang++";
+}
 
-private:
-  ASTContext &Context;
-  json functions = json::array();
-};
+/**
+ * Ask clang's Driver which system include directories a C++ compile uses.
+ *
+ * A libtooling binary derives the resource directory and the C++ standard
+ * library location from its own path, so builtin and libc++ headers are not
+ * found on their own. Building (not running) a driver compilation for the
+ * real clang yields the same -internal-isystem list `clang -E -v` prints,
+ * without spawning a compiler. The directories are returned as -isystem
+ * arguments, plus -isysroot when the toolchain uses an SDK (macOS).
+ */
+static std::vector<std::string> discoverSystemIncludeArgs(const std::string &ClangExecutable,
+                                                          const std::string &Target) {
+  // LLVM 18: the engine takes shared ownership of the options and, by
+  // default, ownership of the consumer
+  IntrusiveRefCntPtr<DiagnosticsEngine> Diags = CompilerInstance::createDiagnostics(
+      new DiagnosticOptions(), new IgnoringDiagConsumer(), /*ShouldOwnClient=*/true);
+  driver::Driver TheDriver(ClangExecutable, Target, *Diags);
+#ifdef CFG_EXPORTER_CLANG_RESOURCE_DIR
+  if (llvm::sys::fs::is_directory(CFG_EXPORTER_CLANG_RESOURCE_DIR)) {
+    TheDriver.ResourceDir = CFG_EXPORTER_CLANG_RESOURCE_DIR;
+  }
+#endif
 
-class CFGExporterASTConsumer : public ASTConsumer {
-public:
-  explicit CFGExporterASTConsumer(ASTContext &Context) : Visitor(Context) {}
+  // "-" (stdin) as input: the driver does not check that it exists
+  const char *Argv[] = {"clang++", "-fsyntax-only", "-x", "c++", "-"};
+  std::unique_ptr<driver::Compilation> Compilation(TheDriver.BuildCompilation(Argv));
 
-  void HandleTranslationUnit(ASTContext &Context) override {
-    Visitor.TraverseDecl(Context.getTranslationUnitDecl());
-    json output = Visitor.getFunctionsJson();
-    llvm::outs() << output.dump(2) << "\n";
+  std::vector<std::string> IncludeArgs;
+  if (!Compilation) {
+    return IncludeArgs;
+  }
+  for (const driver::Command &Job : Compilation->getJobs()) {
+    const llvm::opt::ArgStringList &JobArgs = Job.getArguments();
+    for (size_t i = 0; i + 1 < JobArgs.size(); ++i) {
+      StringRef Arg = JobArgs[i];
+      if (Arg == "-internal-isystem" || Arg == "-internal-externc-isystem") {
+        IncludeArgs.push_back(std::string("-isystem") + JobArgs[++i]);
+      } else if (Arg == "-isysroot") {
+        IncludeArgs.push_back(std::string("-isysroot") + JobArgs[++i]);
+      }
+    }
   }
+  return IncludeArgs;
+}
 
-private:
-  CFGExporterVisitor Visitor;
-};
+/**
+ * System include arguments for this toolchain, cached on disk.
+ *
+ * The cache file lives in the user cache directory and is keyed by the clang
+ * version the exporter is built with, the target triple, the driver path and
+ * SDKROOT. Entries whose directories disappeared (e.g. after an SDK update)
+ * are rediscovered.
+ */
+static std::vector<std::string> getSystemIncludeArgs() {
+  std::string ClangExecutable = findClangExecutable();
+  std::string Target = llvm::sys::getDefaultTargetTriple();
+  const char *SDKRoot = std::getenv("SDKROOT");
 
-class CFGExporterFrontendAction : public ASTFrontendAction {
-public:
-  std::unique_ptr<ASTConsumer> CreateASTConsumer(CompilerInstance &CI, StringRef InFile) override {
-    return std::make_unique<CFGExporterASTConsumer>(CI.getASTContext());
+  llvm::MD5 Hash;
+  Hash.update(getClangFullVersion());
+  Hash.update(Target);
+  Hash.update(ClangExecutable);
+  Hash.update(SDKRoot ? SDKRoot : "");
+  llvm::MD5::MD5Result Digest;
+  Hash.final(Digest);
+
+  llvm::SmallString<256> CachePath;
+  bool HaveCache = llvm::sys::path::cache_directory(CachePath);
+  if (HaveCache) {
+    llvm::sys::path::append(CachePath, "cfg-exporter", "system-includes-" + Digest.digest().str().str() + ".json");
+
+    std::ifstream In(std::string(CachePath.str()));
+    json Cached = json::parse(In, nullptr, /*allow_exceptions=*/false);
+    if (Cached.is_object() && Cached.contains("args") && Cached["args"].is_array()) {
+      std::vector<std::string> Args = Cached["args"].get<std::vector<std::string>>();
+      bool Valid = !Args.empty();
+      for (const std::string &Arg : Args) {
+        StringRef Dir = StringRef(Arg).drop_front(Arg.compare(0, 9, "-isysroot") == 0 ? 9 : 8);
+        Valid = Valid && llvm::sys::fs::is_directory(Dir);
+      }
+      if (Valid) {
+        return Args;
+      }
+    }
   }
-};
+
+  std::vector<std::string> Args = discoverSystemIncludeArgs(ClangExecutable, Target);
+
+  if (HaveCache && !Args.empty()) {
+    // Write to a temporary file and rename, so concurrent exporters never
+    // read a partial cache entry
+    json Entry;
+    Entry["clangVersion"] = getClangFullVersion();
+    Entry["target"] = Target;
+    Entry["clang"] = ClangExecutable;
+    Entry["args"] = Args;
+
+    llvm::sys::fs::create_directories(llvm::sys::path::parent_path(CachePath));
+    std::string TempPath = std::string(CachePath.str()) + ".tmp" + std::to_string(llvm::sys::Process::getProcessId());
+    {
+      std::ofstream Out(TempPath);
+      Out << Entry.dump(2) << "\n";
+    }
+    if (llvm::sys::fs::rename(TempPath, CachePath)) {
+      llvm::sys::fs::remove(TempPath);
+    }
+  }
+
+  return Args;
+}
 
 static llvm::cl::OptionCategory CFGExporterCategory("cfg-exporter options");
 
 int main(int argc, const char **argv) {
-  // Use buildASTFromCodeWithArgs for better cross-platform compatibility
-  // This approach doesn't require a compilation database and works universally
-  
+  // Compiler invocations go through clang::tooling::ToolInvocation with
+  // explicit arguments; a compilation database is only used by --batch
+
   if (argc < 2) {
-    llvm::errs() << "Usage: cfg-exporter <source-file> [-- <compiler-args>]\n";
+    llvm::errs() << "Usage: cfg-exporter [--stream] [--stdin] [--format=json|msgpack|cbor] <source-file> [-- <compiler-args>]\n"
+                 << "       cfg-exporter --serve [--format=json|msgpack|cbor] [-- <compiler-args>]\n"
+                 << "       cfg-exporter --batch [--stream] [--format=json|msgpack|cbor]\n"
+                 << "                    [-p <build-dir> | --compile-commands=<file>] [-j <N>]\n"
+                 << "                    [<source-file>...] [-- <compiler-args>]\n"
+                 << "       --function=<qualified-name|USR>: export only matching functions (repeatable)\n"
+                 << "       --lines=<start>-<end>: export only functions overlapping these lines\n"
+                 << "       --skip-header-bodies: do not parse function bodies outside the main file\n"
+                 << "       --header-functions: with --batch, also export project header functions, once per run\n"
+                 << "       --top-level-statements: one statement per source-level statement, not per subexpression\n"
+                 << "       --simplify-cfg: drop unreachable and empty blocks, fuse straight-line chains\n"
+                 << "       --access-path-depth=<N>: field/index/deref steps kept in access paths (default 3, 0: none)\n"
+                 << "       --taint-spec=<file>: tag call sites with source/sink/sanitizer roles from a registry spec\n"
+                 << "       --intern-strings: emit paths, texts, names and types once, in a string table\n"
+                 << "       --no-system-includes: do not add the toolchain's system include directories\n";
     return 1;
   }
 
-  std::string SourceFile = argv[1];
-  std::vector<std::string> CompilerArgs;
+  std::vector<std::string> InputFiles;
+  bool ServeMode = false;
+  bool BatchMode = false;
+  bool StreamMode = false;
+  bool HeaderFunctions = false;
+  bool InternStrings = false;
+  bool ContentsFromStdin = false;
+  bool DiscoverSystemIncludes = true;
+  ExportOptions Options;
+  OutputFormat Format = OutputFormat::JSON;
+  std::string CompileCommandsPath;
+  unsigned Jobs = std::thread::hardware_concurrency();
+  std::vector<std::string> UserArgs;
   
+  // Parse exporter options, then additional compiler arguments after "--"
+  bool collectArgs = false;
+  for (int i = 1; i < argc; ++i) {
+    std::string Arg = argv[i];
+    if (collectArgs) {
+      UserArgs.push_back(Arg);
+      continue;
+    }
+    if (Arg == "--") {
+      collectArgs = true;
+      continue;
+    }
+    if (Arg == "--serve") {
+      ServeMode = true;
+      continue;
+    }
+    if (Arg == "--batch") {
+      BatchMode = true;
+      continue;
+    }
+    if (Arg == "--stream") {
+      StreamMode = true;
+      continue;
+    }
+    if (Arg == "--stdin") {
+      ContentsFromStdin = true;
+      continue;
+    }
+    if (Arg.compare(0, 11, "--function=") == 0) {
+      Options.Functions.push_back(Arg.substr(11));
+      continue;
+    }
+    if (Arg.compare(0, 8, "--lines=") == 0) {
+      std::pair<unsigned, unsigned> Range;
+      if (!parseLineRange(Arg.substr(8), Range)) {
+        llvm::errs() << "Error: Invalid line range " << Arg.substr(8) << " (expected <start>-<end>)\n";
+        return 1;
+      }
+      Options.Lines = Range;
+      continue;
+    }
+    if (Arg == "--skip-header-bodies") {
+      Options.SkipHeaderFunctionBodies = true;
+      continue;
+    }
+    if (Arg == "--intern-strings") {
+      InternStrings = true;
+      continue;
+    }
+    if (Arg == "--header-functions") {
+      HeaderFunctions = true;
+      continue;
+    }
+    if (Arg == "--top-level-statements") {
+      Options.TopLevelStatements = true;
+      continue;
+    }
+    if (Arg == "--simplify-cfg") {
+      Options.SimplifyCFG = true;
+      continue;
+    }
+    if (Arg.compare(0, 13, "--taint-spec=") == 0) {
+      std::string Error;
+      Options.Taint = TaintSpec::load(Arg.substr(13), Error);
+      if (!Options.Taint) {
+        llvm::errs() << "Error: " << Error << "\n";
+        return 1;
+      }
+      continue;
+    }
+    if (Arg.compare(0, 20, "--access-path-depth=") == 0) {
+      if (StringRef(Arg).substr(20).getAsInteger(10, Options.AccessPathDepth)) {
+        llvm::errs() << "Error: Invalid access path depth " << Arg.substr(20) << " (expected a number of steps)\n";
+        return 1;
+      }
+      continue;
+    }
+    if (Arg == "--no-system-includes") {
+      DiscoverSystemIncludes = false;
+      continue;
+    }
+    if (Arg.compare(0, 9, "--format=") == 0) {
+      if (!parseOutputFormat(Arg.substr(9), Format)) {
+        llvm::errs() << "Error: Unknown output format " << Arg.substr(9) << " (expected json, msgpack or cbor)\n";
+        return 1;
+      }
+      continue;
+    }
+    if (Arg == "-p" && i + 1 < argc) {
+      CompileCommandsPath = argv[++i];
+      continue;
+    }
+    if (Arg.compare(0, 19, "--compile-commands=") == 0) {
+      CompileCommandsPath = Arg.substr(19);
+      continue;
+    }
+    if ((Arg == "-j" && i + 1 < argc) || Arg.compare(0, 7, "--jobs=") == 0) {
+      std::string Value = Arg == "-j" ? argv[++i] : Arg.substr(7);
+      Jobs = static_cast<unsigned>(std::strtoul(Value.c_str(), nullptr, 10));
+      continue;
+    }
+    InputFiles.push_back(Arg);
+  }
+
   // Default compiler arguments for C++ analysis
   // These work across Linux, macOS, and Windows
+  std::vector<std::string> CompilerArgs;
   CompilerArgs.push_back("-std=c++17");
   CompilerArgs.push_back("-fparse-all-comments");
-  
-  // Parse additional compiler arguments after "--"
-  bool collectArgs = false;
-  for (int i = 2; i < argc; ++i) {
-    if (std::string(argv[i]) == "--") {
-      collectArgs = true;
-      continue;
+  CompilerArgs.insert(CompilerArgs.end(), UserArgs.begin(), UserArgs.end());
+
+  // Toolchain include directories (builtin headers, C++ standard library,
+  // SDK); discovered in-process and cached on disk across runs
+  std::vector<std::string> SystemIncludeArgs;
+  if (DiscoverSystemIncludes) {
+    SystemIncludeArgs = getSystemIncludeArgs();
+  }
+  CompilerArgs.insert(CompilerArgs.end(), SystemIncludeArgs.begin(), SystemIncludeArgs.end());
+
+  // The export-once cache spans the translation units of one batch run
+  if (HeaderFunctions && !BatchMode) {
+    llvm::errs() << "Error: --header-functions requires --batch\n";
+    return 1;
+  }
+
+  // In server mode the arguments after "--" apply to every request
+  if (ServeMode) {
+    return runServer(CompilerArgs, Options, Format, InternStrings);
+  }
+
+  if (BatchMode) {
+    std::vector<CompileCommand> Commands;
+    if (!collectBatchCommands(CompileCommandsPath, InputFiles, Commands)) {
+      return 1;
     }
-    if (collectArgs) {
-      CompilerArgs.push_back(argv[i]);
+    // The language standard comes from each compile command, not the defaults
+    std::vector<std::string> BatchArgs = {"-fparse-all-comments"};
+    BatchArgs.insert(BatchArgs.end(), UserArgs.begin(), UserArgs.end());
+    BatchArgs.insert(BatchArgs.end(), SystemIncludeArgs.begin(), SystemIncludeArgs.end());
+    if (HeaderFunctions) {
+      Options.HeaderFunctions = std::make_shared<HeaderFunctionCache>();
     }
+    setBinaryStdout();
+    return runBatch(Commands, Jobs, BatchArgs, Options, StreamMode, Format, InternStrings);
   }
 
-  // Read the source file
-  std::ifstream FileStream(SourceFile);
-  if (!FileStream) {
+  std::string SourceFile = InputFiles.empty() ? "" : InputFiles.front();
+  if (SourceFile.empty() || (!ContentsFromStdin && !llvm::sys::fs::exists(SourceFile))) {
     llvm::errs() << "Error: Could not open file " << SourceFile << "\n";
     return 1;
   }
 
-  std::string Source((std::istreambuf_iterator<char>(FileStream)),
-                     std::istreambuf_iterator<char>());
-  FileStream.close();
+  if (Format != OutputFormat::JSON) {
+    setBinaryStdout();
+  }
 
-  // Build AST from source code with explicit compiler arguments
-  // This is platform-agnostic and doesn't rely on system PATH or SDK discovery
-  auto AST = clang::tooling::buildASTFromCodeWithArgs(
-    Source,
-    CompilerArgs,
-    SourceFile
-  );
+  if (ContentsFromStdin) {
+    // Unsaved buffer: the source text comes from stdin, the path only names it
+#ifdef _WIN32
+    _setmode(_fileno(stdin), _O_BINARY);
+#endif
+    Options.MainFileContents = std::string(std::istreambuf_iterator<char>(std::cin), {});
+  }
+  StringTable Strings;
+  // Streaming: one compact record per function (NDJSON) instead of one document
+  if (StreamMode) {
+    Options.OnFunction = [&Strings, Format, InternStrings](json &&Function) {
+      if (InternStrings) {
+        Strings.internRecord(Function);
+      }
+      writeRecord(Function, Format);
+    };
+  }
 
-  if (!AST) {
-    llvm::errs() << "Error: Failed to build AST\n";
+  ExporterSession Session(CompilerArgs);
+  json output;
+  std::string Error;
+  if (!Session.exportFile(SourceFile, {}, Options, output, Error)) {
+    llvm::errs() << "Error: " << Error << "\n";
     return 1;
   }
 
-  // Process the AST
-  CFGExporterVisitor Visitor(AST->getASTContext());
-  Visitor.TraverseDecl(AST->getASTContext().getTranslationUnitDecl());
-  
-  json output;
-  output["functions"] = Visitor.getFunctionsJson()["functions"];
-  
-  llvm::outs() << output.dump(2) << "\n";
+  if (StreamMode) {
+    // Every function has already been written; the file's globals close the stream
+    json GlobalsRecord;
+    GlobalsRecord["globals"] = std::move(output["globals"]);
+    if (InternStrings) {
+      Strings.internRecord(GlobalsRecord);
+    }
+    writeRecord(GlobalsRecord, Format);
+    return 0;
+  }
+
+  if (InternStrings) {
+    Strings.internRecord(output);
+  }
+  if (Format == OutputFormat::JSON) {
+    llvm::outs() << output.dump(2) << "\n";
+  } else {
+    writeRecord(output, Format);
+  }
 
   return 0;
 }
@@ -0,0 +1,277 @@
+/**
+ * CFGExporterClient.ts
+ *
+ * Client for the long-lived cfg-exporter server (cfg-exporter --serve)
+ *
+ * PURPOSE:
+ * Spawning cfg-exporter once per analyzed file pays for loading libLLVM/libclang,
+ * driver setup and system header lookups on every run. This client keeps a single
+ * exporter process alive and sends it one request per file instead.
+ *
+ * SIGNIFICANCE IN OVERALL FLOW:
+ * Used by ClangASTParser.ts in place of a per-file child process. When the server
+ * cannot be started (e.g. an older exporter binary without --serve), ClangASTParser
+ * falls back to the one-shot invocation.
+ *
+ * DATA FLOW:
+ * INPUTS:
+ *   - Requests from ClangASTParser.ts (method + params, e.g. file path and args)
+ *
+ * PROCESSING:
+ *   1. Lazily spawns `cfg-exporter --serve --format=<format> -- <default args>`
+ *   2. Writes each request as a Content-Length framed JSON payload to stdin
+ *   3. Splits stdout into frames and resolves the pending request with the same id;
+ *      intermediate frames (e.g. streamed functions) go to the request's notification callback
+ *   4. Rejects all pending requests if the process exits, or stops it and rejects them
+ *      on a frame that cannot be decoded; the next request respawns it
+ *
+ * OUTPUTS:
+ *   - Decoded `result` object of each response -> ClangASTParser.ts
+ *
+ * PROTOCOL:
+ *   Content-Length: <bytes>\r\n
+ *   \r\n
+ *   {"id":1,"method":"export","params":{"file":"...","args":[]}}
+ *
+ *   Requests are always JSON; response payloads are JSON or MessagePack,
+ *   depending on the format the client was created with.
+ */
+
+import * as child_process from 'child_process';
+import * as fs from 'fs';
+import { decodeMessagePack } from './MessagePackDecoder';
+
+/**
+ * Receives intermediate frames of a request, e.g. `{"id":1,"function":{...}}`
+ * for exports with `stream: true`
+ */
+export type NotificationCallback = (frame: any) => void;
+
+interface PendingRequest {
+  resolve: (result: any) => void;
+  reject: (error: Error) => void;
+  onNotification?: NotificationCallback;
+}
+
+const HEADER_SEPARATOR = Buffer.from('\r\n\r\n');
+
+/**
+ * Encoding of the server's response frames
+ */
+export type ExporterWireFormat = 'json' | 'msgpack';
+
+export class CFGExporterClient {
+  private child: child_process.ChildProcessWithoutNullStreams | null = null;
+  private pending = new Map<number, PendingRequest>();
+  private buffer: Buffer = Buffer.alloc(0);
+  private nextId = 1;
+  private stderrTail = '';
+
+  /**
+   * @param exporterPath - Path to the cfg-exporter binary
+   * @param defaultArgs - Compiler arguments applied to every request (passed after `--`)
+   * @param format - Encoding of response frames (MessagePack is smaller and decodes faster)
+   */
+  constructor(private exporterPath: string, private defaultArgs: string[],
+              private format: ExporterWireFormat = 'json') {}
+
+  /**
+   * Send a request to the exporter server.
+   *
+   * @param method - Server method (e.g. 'export')
+   * @param params - Method parameters
+   * @param onNotification - Receives frames sent before the final response
+   * @returns The `result` member of the response
+   * @throws Error if the server reports an error or exits before answering
+   */
+  request(method: string, params: Record<string, any>, onNotification?: NotificationCallback): Promise<any> {
+    const child = this.ensureStarted();
+    const id = this.nextId++;
+    const payload = Buffer.from(JSON.stringify({ id, method, params }), 'utf8');
+
+    return new Promise((resolve, reject) => {
+      this.pending.set(id, { resolve, reject, onNotification });
+      child.stdin.write(`Content-Length: ${payload.length}\r\n\r\n`);
+      child.stdin.write(payload);
+    });
+  }
+
+  /**
+   * Load and delete the result file of a request sent with `resultFile: true`.
+   *
+   * The file is read into a single Buffer and decoded in place, so a large
+   * result is neither split into pipe chunks nor turned into a JS string.
+   *
+   * @param result - The `{ path, length }` result of the request
+   * @returns The decoded result
+   * @throws Error if the file is missing, truncated or malformed
+   */
+  loadResultFile(result: { path: string; length: number }): any {
+    try {
+      const data = fs.readFileSync(result.path);
+      if (data.length !== result.length) {
+        throw new Error(`expected ${result.length} bytes, found ${data.length}`);
+      }
+      return this.format === 'msgpack' ? decodeMessagePack(data) : JSON.parse(data.toString('utf8'));
+    } catch (error: any) {
+      throw new Error(`Failed to load cfg-exporter result file ${result.path}: ${error.message}`);
+    } finally {
+      fs.rm(result.path, { force: true }, () => {});
+    }
+  }
+
+  /**
+   * Whether a server process is currently running.
+   */
+  isRunning(): boolean {
+    return this.child !== null;
+  }
+
+  /**
+   * Stop the server process and reject outstanding requests.
+   */
+  dispose(): void {
+    if (this.child) {
+      this.child.stdin.end();
+      this.child.kill();
+      this.child = null;
+    }
+    this.rejectAll(new Error('cfg-exporter server disposed'));
+  }
+
+  private ensureStarted(): child_process.ChildProcessWithoutNullStreams {
+    if (this.child) {
+      return this.child;
+    }
+
+    const child = child_process.spawn(this.exporterPath,
+      ['--serve', `--format=${this.format}`, '--', ...this.defaultArgs]);
+    this.child = child;
+    this.buffer = Buffer.alloc(0);
+    this.stderrTail = '';
+
+    // Output of a server stopped by fail() must not reach its successor's buffer
+    child.stdout.on('data', (data: Buffer) => {
+      if (this.child === child) {
+        this.onData(data);
+      }
+    });
+
+    // Diagnostics go to stderr; keep the tail for error messages only
+    child.stderr.on('data', (data: Buffer) => {
+      this.stderrTail = (this.stderrTail + data.toString()).slice(-4096);
+    });
+
+    // A server stopped by dispose() or fail() has had its requests rejected
+    // already; pending requests now belong to its successor
+    child.on('exit', (code) => {
+      if (this.child !== child) {
+        return;
+      }
+      this.child = null;
+      this.rejectAll(new Error(`cfg-exporter server exited with code ${code}: ${this.stderrTail}`));
+    });
+
+    child.on('error', (error) => {
+      if (this.child !== child) {
+        return;
+      }
+      this.child = null;
+      this.rejectAll(new Error(`Failed to spawn cfg-exporter server: ${error.message}`));
+    });
+
+    console.log(`[CFGExporterClient] Started cfg-exporter server (pid ${child.pid})`);
+    return child;
+  }
+
+  /**
+   * Append stdout data and dispatch every complete frame.
+   */
+  private onData(data: Buffer): void {
+    this.buffer = this.buffer.length === 0 ? data : Buffer.concat([this.buffer, data]);
+
+    while (true) {
+      const headerEnd = this.buffer.indexOf(HEADER_SEPARATOR);
+      if (headerEnd === -1) {
+        return;
+      }
+
+      const header = this.buffer.subarray(0, headerEnd).toString('ascii');
+      const lengthMatch = header.match(/Content-Length:\s*(\d+)/i);
+      if (!lengthMatch) {
+        this.fail(new Error(`Malformed cfg-exporter frame header: ${header.slice(0, 80)}`));
+        return;
+      }
+
+      const bodyStart = headerEnd + HEADER_SEPARATOR.length;
+      const bodyEnd = bodyStart + parseInt(lengthMatch[1], 10);
+      if (this.buffer.length < bodyEnd) {
+        return;
+      }
+
+      const body = this.buffer.subarray(bodyStart, bodyEnd);
+      this.buffer = this.buffer.subarray(bodyEnd);
+      this.dispatch(body);
+    }
+  }
+
+  private dispatch(body: Buffer): void {
+    let response: any;
+    try {
+      response = this.format === 'msgpack' ? decodeMessagePack(body) : JSON.parse(body.toString('utf8'));
+    } catch (error: any) {
+      // The frame's id cannot be read, so it cannot be matched to its request;
+      // nothing after it can be trusted either
+      this.fail(new Error(`Malformed cfg-exporter response frame: ${error.message}`));
+      return;
+    }
+
+    const request = this.pending.get(response.id);
+    if (!request) {
+      console.warn(`[CFGExporterClient] Response for unknown request id ${response.id}`);
+      return;
+    }
+
+    // Frames without result/error are intermediate; the request stays pending
+    if (!('result' in response) && !('error' in response)) {
+      if (request.onNotification) {
+        try {
+          request.onNotification(response);
+        } catch (error: any) {
+          this.pending.delete(response.id);
+          request.reject(error);
+        }
+      }
+      return;
+    }
+    this.pending.delete(response.id);
+
+    if (response.error) {
+      request.reject(new Error(`cfg-exporter: ${response.error.message}`));
+    } else {
+      request.resolve(response.result);
+    }
+  }
+
+  /**
+   * Stop the server after a protocol error and reject every outstanding
+   * request with it; the next request starts a new server.
+   */
+  private fail(error: Error): void {
+    console.error(`[CFGExporterClient] ${error.message}`);
+    const child = this.child;
+    this.child = null;
+    this.buffer = Buffer.alloc(0);
+    this.rejectAll(error);
+    if (child) {
+      child.stdin.end();
+      child.kill();
+    }
+  }
+
+  private rejectAll(error: Error): void {
+    const requests = Array.from(this.pending.values());
+    this.pending.clear();
+    requests.forEach(request => request.reject(error));
+  }
+}
@@ -21,7 +21,8 @@
  * 
  * PROCESSING:
  *   1. Indexes all functions with metadata (name, parameters, return type)
- *   2. Extracts function calls from CFG statements using FunctionCallExtractor
+ *   2. Takes resolved call sites from cfg-exporter blocks, or extracts function
+ *      calls from CFG statements using FunctionCallExtractor
  *   3. Builds caller->callee relationship map (callsFrom)
  *   4. Builds callee->caller relationship map (callsTo)
  *   5. Analyzes recursion patterns (direct, mutual, tail recursion)
@@ -59,7 +60,7 @@
  * - Chapter 9: Inter-Procedural Analysis, "Engineering a Compiler"
  */
 
-import { FunctionCFG, BasicBlock, Statement } from '../types';
+import { FunctionCFG, BasicBlock, Statement, CallSite } from '../types';
 import { FunctionCallExtractor } from './FunctionCallExtractor';
 
 /**
@@ -74,6 +75,10 @@ export interface FunctionCall {
   // Function being called (callee)
   calleeId: string;
 
+  // Resolved callee, when the call site comes from cfg-exporter
+  calleeQualifiedName?: string;
+  calleeUsr?: string;          // Distinguishes overloads sharing calleeId
+
   // Where in the CFG the call occurs
   callSite: {
     blockId: string;         // CFG block ID
@@ -90,6 +95,9 @@ export interface FunctionCall {
 
   // Whether the return value is used
   returnValueUsed: boolean;
+
+  // Variable the return value is assigned to (resolved call sites only)
+  assignedTo?: string;
 }
 
 /**
@@ -167,6 +175,8 @@ export class CallGraphAnalyzer {
   // Internal state
   private callGraph: CallGraph;
   private allFunctions: Map<string, FunctionCFG>;
+  // USR -> function key, to resolve exported call sites to overloads
+  private functionsByUsr: Map<string, string> = new Map();
   private keywords: Set<string> = new Set([
     'if', 'else', 'while', 'for', 'do', 'switch', 'case', 'default',
     'return', 'break', 'continue', 'goto', 'sizeof', 'typedef',
@@ -253,6 +263,9 @@ export class CallGraphAnalyzer {
       };
 
       this.callGraph.functions.set(funcName, metadata);
+      if (funcCFG.usr) {
+        this.functionsByUsr.set(funcCFG.usr, funcName);
+      }
       console.log(`[CG]   Indexed function: ${funcName} with ${parameters.length} params`);
     }
   }
@@ -267,6 +280,15 @@ export class CallGraphAnalyzer {
    * @returns Array of parameter metadata
    */
   private extractParameters(cfg: FunctionCFG): FunctionMetadata['parameters'] {
+    // Exported signatures carry the declared types
+    if (cfg.signature) {
+      return cfg.signature.parameters.map((param, position) => ({
+        name: param.name,
+        type: param.canonicalType,
+        position
+      }));
+    }
+
     // Parameters are already extracted by EnhancedCPPParser and stored in cfg.parameters
     // Convert from string[] to ParameterMetadata[]
     return cfg.parameters.map(paramName => ({
@@ -285,6 +307,10 @@ export class CallGraphAnalyzer {
    * @returns Inferred return type
    */
   private inferReturnType(cfg: FunctionCFG): string {
+    if (cfg.signature) {
+      return cfg.signature.returnType;
+    }
+
     // Check for return statements in CFG
     for (const block of cfg.blocks.values()) {
       for (const stmt of block.statements) {
@@ -323,25 +349,21 @@ export class CallGraphAnalyzer {
     for (const [callerName, callerCFG] of this.allFunctions.entries()) {
       // STEP 2: Iterate through all blocks in the function
       for (const [blockId, block] of callerCFG.blocks.entries()) {
-        // STEP 3: Iterate through all statements in the block
-        for (const stmt of block.statements) {
-          // STEP 4: Find all function calls in this statement
-          const calls = this.findCallsInStatement(
-            stmt,
-            callerName,
-            blockId
+        // STEP 3: Find all function calls in the block. Blocks exported with
+        // resolved call sites need no statement parsing.
+        const calls: FunctionCall[] = block.callSites
+          ? block.callSites.map(site => this.callFromCallSite(site, callerName, blockId))
+          : block.statements.flatMap(stmt => this.findCallsInStatement(stmt, callerName, blockId));
+
+        // STEP 4: Record each call
+        for (const call of calls) {
+          this.callGraph.calls.push(call);
+          callCount++;
+
+          console.log(
+            `[CG]   Call: ${call.callerId} -> ${call.calleeId} ` +
+            `(${call.arguments.actual.length} args) at block ${blockId}`
           );
-
-          // STEP 5: Record each call
-          for (const call of calls) {
-            this.callGraph.calls.push(call);
-            callCount++;
-
-            console.log(
-              `[CG]   Call: ${call.callerId} -> ${call.calleeId} ` +
-              `(${call.arguments.actual.length} args) at block ${blockId}`
-            );
-          }
         }
       }
     }
@@ -349,6 +371,34 @@ export class CallGraphAnalyzer {
     console.log(`[CG] Found ${callCount} function calls total`);
   }
 
+  /**
+   * Convert a call site resolved by cfg-exporter into a FunctionCall.
+   *
+   * Callee, arguments and return-value use come from the Clang AST, so no
+   * statement text is parsed. Callees defined in the program are matched by
+   * USR, which tells overloads apart.
+   */
+  private callFromCallSite(site: CallSite, callerName: string, blockId: string): FunctionCall {
+    return {
+      callerId: callerName,
+      calleeId: (site.usr && this.functionsByUsr.get(site.usr)) || site.name,
+      calleeQualifiedName: site.callee ?? undefined,
+      calleeUsr: site.usr,
+      callSite: {
+        blockId,
+        statementId: site.statementId || `${blockId}_call_${site.name}`,
+        line: site.range?.start.line ?? 0,
+        column: site.range?.start.column ?? 0
+      },
+      arguments: {
+        actual: site.arguments.map(arg => arg.text),
+        types: site.arguments.map(arg => arg.type)
+      },
+      returnValueUsed: site.returnUsed,
+      assignedTo: site.assignedTo
+    };
+  }
+
   /**
    * Find all function calls within a single statement.
    * 
@@ -21,11 +21,11 @@
  *   - cfg-exporter binary (located at cpp-tools/cfg-exporter/build/cfg-exporter)
  * 
  * PROCESSING:
- *   1. Spawns cfg-exporter process with source file path
+ *   1. Sends the source file to a persistent cfg-exporter server (CFGExporterClient.ts),
+ *      or spawns a one-shot cfg-exporter process if the server is unavailable
  *   2. Reads JSON output from cfg-exporter stdout
  *   3. Parses JSON to ASTNode structure
  *   4. Handles errors and timeouts
- *   5. Caches include paths for performance
  * 
  * OUTPUTS:
  *   - ASTNode object containing:
@@ -44,7 +44,6 @@
  * - CFG block extraction with predecessors/successors
  * - Statement-level granularity for dataflow analysis
  * - Cross-platform support (macOS, Linux, Windows)
- * - Include path discovery and caching
  * 
  * ACADEMIC FOUNDATION:
  * - CFGs follow the standard compiler textbook representation
@@ -60,8 +59,11 @@
 import * as child_process from 'child_process';
 import * as util from 'util';
 import * as path from 'path';
-import { Range, Statement, StatementType } from '../types';
+import { AccessPath, AccessStep, BlockTerminator, CallSite, ExportedGlobal, ExportedVariable, FunctionSignature, Range, Statement, StatementType } from '../types';
 import { FunctionCallExtractor } from './FunctionCallExtractor';
+import { CFGExporterClient } from './CFGExporterClient';
+import { decodeMessagePack, MessagePackStreamDecoder } from './MessagePackDecoder';
+import { InternedStringTable } from './InternedStrings';
 
 /**
  * Represents a source code location (file, line, column, offset).
@@ -133,13 +135,36 @@ export interface ASTNode {
   label?: string;
   statements?: Statement[];
   successors?: string[];
+  infeasibleSuccessors?: string[];
   predecessors?: string[];
   isEntry?: boolean;
   isExit?: boolean;
+  variableTable?: ExportedVariable[];
+  callSites?: CallSite[];
+  terminator?: BlockTerminator | null;
+  immediateDominator?: string;
+  immediatePostDominator?: string;
+  controlDependencies?: string[];
+  rpo?: number;
+  postorder?: number;
+  backEdges?: string[];
+  loopHeader?: string;
+  loopDepth?: number;
+  mergedBlocks?: string[];
+  signature?: FunctionSignature;
+  usr?: string;
+  bodyHash?: string;
+  globalAccess?: { reads: string[]; writes: string[] };
+  taintTagged?: boolean;
+  globals?: ExportedGlobal[];  // TranslationUnit only
 }
 
 const exec = util.promisify(child_process.exec);
 
+// Source size from which whole-file exports are handed over through a result
+// file; smaller results cost less as a regular response than a temporary file
+const RESULT_FILE_MIN_SOURCE_BYTES = 256 * 1024;
+
 export interface ClangASTNode {
   kind: string;
   name?: string;
@@ -160,92 +185,65 @@ export interface ClangASTNode {
   isDefinition?: boolean;
 }
 
+/**
+ * Per-call options for ClangASTParser.parseFile
+ */
+export interface ParseOptions {
+  // Keep the file's AST and precompiled preamble in the exporter server so the
+  // next parse of the same file only re-parses the main-file body (keystroke mode)
+  keepAlive?: boolean;
+  // Unsaved editor contents to analyze in place of the file on disk; the
+  // exporter maps them over the file's path, so includes resolve as usual
+  contents?: string;
+  // Export only these functions (qualified name, plain name or USR); only
+  // their CFGs are built, so a re-parse costs in proportion to the selection
+  functions?: string[];
+  // Export only functions overlapping this 1-based, inclusive line range
+  lines?: { start: number; end: number };
+  // Export simplified CFGs (unreachable and empty blocks dropped, straight-line
+  // chains fused; see cfg-exporter --simplify-cfg)
+  simplifyCFG?: boolean;
+  // Registry spec file (see TaintRegistrySpec) to tag call sites with their
+  // taint source/sink/sanitizer role
+  taintSpec?: string;
+  // Receives each function of a streamed export as soon as it is converted,
+  // while the exporter is still working on the rest of the file (result-file
+  // and one-shot exports deliver all functions at once and do not call it)
+  onFunction?: (func: ASTNode) => void;
+}
+
+/**
+ * Options for ClangASTParser.parseFilesBatch
+ */
+export interface BatchParseOptions {
+  // compile_commands.json (or its directory) providing per-file compiler flags
+  compileCommandsPath?: string;
+  // Number of exporter worker threads (defaults to one per core)
+  jobs?: number;
+  // Export simplified CFGs (see ParseOptions.simplifyCFG)
+  simplifyCFG?: boolean;
+  // Tag call sites with taint roles (see ParseOptions.taintSpec)
+  taintSpec?: string;
+  // Also export functions defined in project headers, each once per run
+  // (reported under the header's path after all translation units)
+  headerFunctions?: boolean;
+}
+
+/**
+ * Called once per translation unit as soon as the batch exporter finishes it
+ */
+export type BatchFileCallback = (filePath: string, ast: ASTNode | null, error?: Error) => void;
+
 export class ClangASTParser {
   private clangPath: string | null = null;
-  private cachedIncludePaths: string[] | null = null;
+  // Persistent `cfg-exporter --serve` process shared by all parseFile calls
+  private exporterClient: CFGExporterClient | null = null;
+  private exporterServerVerified = false;
+  private exporterServerDisabled = false;
 
   constructor() {
+    // System include directories are discovered (and cached) by cfg-exporter itself
     this.clangPath = this.findClang();
-    // Discover include paths once during initialization
-    this.cachedIncludePaths = this.discoverIncludePaths();
-  }
-
-  /**
-   * Discover clang's include paths by querying the compiler directly
-   * This ensures compatibility with different LLVM/SDK versions
-   */
-  private discoverIncludePaths(): string[] {
-    const paths: string[] = [];
-    
-    try {
-      const { execSync } = require('child_process');
-      const clangPath = this.clangPath || '/opt/homebrew/opt/llvm/bin/clang';
-      
-      try {
-        // Run clang in verbose mode to see where it looks for headers
-        // This gives us the exact SDK and system paths clang is using
-        const output = execSync(`${clangPath} -E -v -x c++ /dev/null 2>&1`, {
-          encoding: 'utf8',
-          maxBuffer: 10 * 1024 * 1024
-        });
-        
-        // Parse the output to extract include paths
-        const lines = output.split('\n');
-        let inSearchPaths = false;
-        
-        for (const line of lines) {
-          // Start collecting after "search list:" marker
-          if (line.includes('search list:')) {
-            inSearchPaths = true;
-            continue;
-          }
-          
-          // Stop at the end of search paths (empty line or new section)
-          if (inSearchPaths && line.trim() === '') {
-            break;
-          }
-          
-          // Collect actual paths
-          if (inSearchPaths) {
-            const trimmedPath = line.trim();
-            if (trimmedPath && trimmedPath.startsWith('/')) {
-              paths.push(`-isystem${trimmedPath}`);
-            }
-          }
-        }
-        
-        console.log('Discovered clang include paths:', paths.length > 0 ? paths : 'none found');
-      } catch (verboseError) {
-        console.log('Verbose clang query failed, trying xcrun for SDK path');
-        
-        // Fallback: use xcrun to get SDK path on macOS
-        try {
-          const sdkPath = execSync('xcrun --show-sdk-path 2>/dev/null', {
-            encoding: 'utf8'
-          }).trim();
-          
-          if (sdkPath) {
-            paths.push(`-isysroot${sdkPath}`);
-            paths.push(`-isystem${sdkPath}/usr/include`);
-          }
-        } catch (sdkError) {
-          // Ignore SDK discovery failure
-        }
-        
-        // Add Homebrew LLVM paths as fallback
-        paths.push('-I/opt/homebrew/opt/llvm/include/c++/v1');
-        paths.push('-I/opt/homebrew/opt/llvm/lib/clang/21.1.5/include');
-        paths.push('-isystem/usr/include');
-      }
-    } catch (err) {
-      console.log('Include path discovery failed completely, using hardcoded fallbacks');
-      // Absolute fallback
-      paths.push('-I/opt/homebrew/opt/llvm/include/c++/v1');
-      paths.push('-I/opt/homebrew/opt/llvm/lib/clang/21.1.5/include');
-      paths.push('-isystem/usr/include');
-    }
-    
-    return paths;
   }
 
   /**
@@ -273,13 +271,22 @@ export class ClangASTParser {
       '/opt/homebrew/bin/clang++'
     ];
 
-    // Try each location using 'which' command
+    // Check each location on the file system; bare names are looked up in PATH.
+    // No process is spawned, so extension activation stays cheap.
+    const fs = require('fs');
+    const searchDirs = (process.env.PATH || '').split(path.delimiter).filter(dir => dir);
+    const extensions = process.platform === 'win32' ? ['.exe', ''] : [''];
+
     for (const clang of possiblePaths) {
-      try {
-        child_process.execSync(`which ${clang}`, { stdio: 'ignore' });
-        return clang;  // Found - return this path
-      } catch {
-        continue;      // Not found at this location - try next
+      const candidates = path.isAbsolute(clang)
+        ? [clang]
+        : searchDirs.map(dir => path.join(dir, clang));
+      for (const candidate of candidates) {
+        for (const extension of extensions) {
+          if (fs.existsSync(candidate + extension)) {
+            return clang;  // Found - return this path
+          }
+        }
       }
     }
 
@@ -308,10 +315,11 @@ export class ClangASTParser {
    * 
    * @param filePath - Path to C++ source file
    * @param args - Additional compiler arguments
+   * @param options - Per-call options (e.g. keepAlive for keystroke-mode reparses)
    * @returns AST representation of the file's functions
    * @throws Error if clang is not available or parsing fails
    */
-  async parseFile(filePath: string, args: string[] = []): Promise<ASTNode | null> {
+  async parseFile(filePath: string, args: string[] = [], options: ParseOptions = {}): Promise<ASTNode | null> {
     if (!this.clangPath) {
       throw new Error('Clang is not available');
     }
@@ -334,7 +342,7 @@ export class ClangASTParser {
       ];
 
       // Use streaming parser for large files
-      return await this.parseFileStreaming(filePath, clangArgs);
+      return await this.parseFileStreaming(filePath, clangArgs, options);
     } catch (error: any) {
       console.error('Error parsing with clang:', error.message);
       throw error;
@@ -343,64 +351,218 @@ export class ClangASTParser {
 
   /**
    * Parse file using cfg-exporter binary that outputs JSON
-   * Uses the libclang-based exporter for clean, structured CFG output
+   * Uses the libclang-based exporter for clean, structured CFG output.
+   * Requests go to a persistent `cfg-exporter --serve` process; if the server
+   * cannot be used, a one-shot exporter process is spawned for the file.
    */
-  private async parseFileStreaming(filePath: string, clangArgs: string[]): Promise<ASTNode | null> {
-    return new Promise((resolve, reject) => {
-      // Build path to cfg-exporter binary
-      // Relative path: from src/analyzer -> src -> . (root) -> cpp-tools/cfg-exporter/build/cfg-exporter
-      // Windows: build/Release/cfg-exporter.exe
-      // Unix: build/cfg-exporter
-      const fs = require('fs');
-      const isWindows = process.platform === 'win32';
-      
-      // Try Windows path first (Release subdirectory + .exe extension)
-      let exporterPath = path.join(__dirname, '..', '..', 'cpp-tools', 'cfg-exporter', 'build', 'Release', isWindows ? 'cfg-exporter.exe' : 'cfg-exporter');
-      
-      // If Windows path doesn't exist, try Unix path (directly in build/)
-      if (!fs.existsSync(exporterPath)) {
-        exporterPath = path.join(__dirname, '..', '..', 'cpp-tools', 'cfg-exporter', 'build', isWindows ? 'cfg-exporter.exe' : 'cfg-exporter');
-      }
-      
-      // If still not found, try without extension (for Unix compatibility)
-      if (!fs.existsSync(exporterPath)) {
-        exporterPath = path.join(__dirname, '..', '..', 'cpp-tools', 'cfg-exporter', 'build', 'cfg-exporter');
-      }
-      
+  private async parseFileStreaming(filePath: string, clangArgs: string[], options: ParseOptions = {}): Promise<ASTNode | null> {
+    const exporterPath = this.findExporter();
+
+    const client = this.getExporterClient(exporterPath);
+    if (client) {
       try {
-        // Check if exporter exists
-        if (!fs.existsSync(exporterPath)) {
-          const buildInstructions = isWindows 
-            ? 'cd cpp-tools\\cfg-exporter\\build && cmake .. -G "Visual Studio 17 2022" -A x64 && cmake --build . --config Release'
-            : 'cd cpp-tools/cfg-exporter && mkdir -p build && cd build && cmake .. && cmake --build .';
-          reject(new Error(`cfg-exporter binary not found at ${exporterPath}. Please build it first: ${buildInstructions}`));
-          return;
+        if (!options.keepAlive && this.getSourceSize(filePath, options) >= RESULT_FILE_MIN_SOURCE_BYTES) {
+          // Exports of large files can be huge (generated code): the server writes
+          // the result to a temporary file and only its path crosses the pipe
+          const handle = await client.request('export', {
+            file: filePath,
+            args: [],
+            contents: options.contents,
+            skipHeaderBodies: true,
+            topLevelStatements: true,
+            simplifyCFG: options.simplifyCFG === true,
+            ...(options.taintSpec ? { taintSpec: options.taintSpec } : {}),
+            ...this.selectionParams(options),
+            internStrings: true,
+            resultFile: true
+          });
+          this.exporterServerVerified = true;
+          const document = new InternedStringTable().resolveRecord(client.loadResultFile(handle));
+          const cfgData = this.parseCFGExporterJSON(document, filePath);
+          console.log('Parsed CFG with', cfgData ? Object.keys(cfgData.inner || {}).length : 0, 'functions (server)');
+          return cfgData;
+        }
+
+        // Other exports (and all keystroke reparses) are streamed one frame per
+        // function and converted as they arrive, so the per-file document is
+        // never built at once
+        const functions: ASTNode[] = [];
+        const strings = new InternedStringTable();
+        const result = await client.request('export', {
+          file: filePath,
+          args: [],
+          keepAlive: options.keepAlive === true,
+          contents: options.contents,
+          skipHeaderBodies: true,
+          topLevelStatements: true,
+          simplifyCFG: options.simplifyCFG === true,
+          ...(options.taintSpec ? { taintSpec: options.taintSpec } : {}),
+          ...this.selectionParams(options),
+          internStrings: true,
+          stream: true
+        }, (frame) => {
+          strings.resolveRecord(frame);
+          if (frame.function) {
+            const func = this.addExportedFunction(functions, frame.function);
+            options.onFunction?.(func);
+          }
+        });
+        this.exporterServerVerified = true;
+        strings.resolveRecord(result);
+        console.log('Parsed CFG with', functions.length, 'functions (server)');
+        return { kind: 'TranslationUnit', inner: this.keyFunctions(functions), globals: result?.globals };
+      } catch (error: any) {
+        // A server that dies before answering its first request is most likely an
+        // exporter binary built without --serve: stop trying for this session
+        if (!this.exporterServerVerified) {
+          console.warn('cfg-exporter server unavailable, falling back to one-shot mode:', error.message);
+          this.exporterServerDisabled = true;
+          client.dispose();
+          this.exporterClient = null;
+        } else if (!client.isRunning()) {
+          console.warn('cfg-exporter server exited, retrying in one-shot mode:', error.message);
+        } else {
+          throw error;
         }
-      } catch (err) {
-        reject(new Error(`Failed to check cfg-exporter path: ${err}`));
-        return;
       }
+    }
+
+    return this.runExporterOnce(exporterPath, filePath, options);
+  }
+
+  /**
+   * Size in bytes of the source to export: the unsaved contents if given,
+   * else the file on disk (0 if it cannot be read)
+   */
+  private getSourceSize(filePath: string, options: ParseOptions): number {
+    if (options.contents !== undefined) {
+      return Buffer.byteLength(options.contents);
+    }
+    const fs = require('fs');
+    try {
+      return fs.statSync(filePath).size;
+    } catch {
+      return 0;
+    }
+  }
+
+  /**
+   * Function/line selection of ParseOptions as exporter request params
+   */
+  private selectionParams(options: ParseOptions): Record<string, any> {
+    const params: Record<string, any> = {};
+    if (options.functions && options.functions.length > 0) {
+      params.functions = options.functions;
+    }
+    if (options.lines) {
+      params.lines = `${options.lines.start}-${options.lines.end}`;
+    }
+    return params;
+  }
 
-      // Use cached include paths discovered during initialization
-      // This ensures the exporter has access to all necessary C++ and C system headers
+  /**
+   * Locate the cfg-exporter binary built under cpp-tools/cfg-exporter/build
+   *
+   * @throws Error with build instructions if the binary does not exist
+   */
+  private findExporter(): string {
+    // Build path to cfg-exporter binary
+    // Relative path: from src/analyzer -> src -> . (root) -> cpp-tools/cfg-exporter/build/cfg-exporter
+    // Windows: build/Release/cfg-exporter.exe
+    // Unix: build/cfg-exporter
+    const fs = require('fs');
+    const isWindows = process.platform === 'win32';
+    
+    // Try Windows path first (Release subdirectory + .exe extension)
+    let exporterPath = path.join(__dirname, '..', '..', 'cpp-tools', 'cfg-exporter', 'build', 'Release', isWindows ? 'cfg-exporter.exe' : 'cfg-exporter');
+    
+    // If Windows path doesn't exist, try Unix path (directly in build/)
+    if (!fs.existsSync(exporterPath)) {
+      exporterPath = path.join(__dirname, '..', '..', 'cpp-tools', 'cfg-exporter', 'build', isWindows ? 'cfg-exporter.exe' : 'cfg-exporter');
+    }
+    
+    // If still not found, try without extension (for Unix compatibility)
+    if (!fs.existsSync(exporterPath)) {
+      exporterPath = path.join(__dirname, '..', '..', 'cpp-tools', 'cfg-exporter', 'build', 'cfg-exporter');
+    }
+    
+    let exists = false;
+    try {
+      exists = fs.existsSync(exporterPath);
+    } catch (err) {
+      throw new Error(`Failed to check cfg-exporter path: ${err}`);
+    }
+
+    if (!exists) {
+      const buildInstructions = isWindows 
+        ? 'cd cpp-tools\\cfg-exporter\\build && cmake .. -G "Visual Studio 17 2022" -A x64 && cmake --build . --config Release'
+        : 'cd cpp-tools/cfg-exporter && mkdir -p build && cd build && cmake .. && cmake --build .';
+      throw new Error(`cfg-exporter binary not found at ${exporterPath}. Please build it first: ${buildInstructions}`);
+    }
+
+    return exporterPath;
+  }
+
+  /**
+   * Get (or create) the client for the persistent exporter server
+   *
+   * @returns The client, or null if server mode was disabled for this session
+   */
+  private getExporterClient(exporterPath: string): CFGExporterClient | null {
+    if (this.exporterServerDisabled) {
+      return null;
+    }
+    if (!this.exporterClient) {
+      this.exporterClient = new CFGExporterClient(exporterPath, ['-std=c++17'], 'msgpack');
+      this.exporterServerVerified = false;
+    }
+    return this.exporterClient;
+  }
+
+  /**
+   * Run a dedicated cfg-exporter process for a single file
+   *
+   * @param options - Unsaved contents (piped to the exporter's stdin) and function/line selection
+   */
+  private runExporterOnce(exporterPath: string, filePath: string, options: ParseOptions = {}): Promise<ASTNode | null> {
+    const contents = options.contents;
+    const selectionArgs = (options.functions || []).map(name => `--function=${name}`);
+    if (options.lines) {
+      selectionArgs.push(`--lines=${options.lines.start}-${options.lines.end}`);
+    }
+
+    return new Promise((resolve, reject) => {
+      // MessagePack output is several times smaller than JSON text and is
+      // decoded straight from the collected buffers
       const exporArgs = [
+        '--format=msgpack',
+        '--skip-header-bodies',
+        '--top-level-statements',
+        '--intern-strings',
+        ...(options.simplifyCFG ? ['--simplify-cfg'] : []),
+        ...(options.taintSpec ? [`--taint-spec=${options.taintSpec}`] : []),
+        ...selectionArgs,
+        ...(contents !== undefined ? ['--stdin'] : []),
         filePath,
         '--',
-        '-std=c++17',
-        ...(this.cachedIncludePaths || [])
+        '-std=c++17'
       ];
 
       const child = child_process.spawn(exporterPath, exporArgs);
-      let output = '';
+      if (contents !== undefined) {
+        child.stdin.end(contents);
+      }
+      const chunks: Buffer[] = [];
+      let outputSize = 0;
       let errorOutput = '';
       const maxBufferSize = 1000 * 1024 * 1024; // 1GB max
 
       child.stdout.on('data', (data: Buffer) => {
-        const chunk = data.toString();
-        output += chunk;
+        chunks.push(data);
+        outputSize += data.length;
 
         // Check buffer size
-        if (output.length > maxBufferSize) {
+        if (outputSize > maxBufferSize) {
           child.kill();
           reject(new Error('CFG exporter output exceeded maximum buffer size'));
           return;
@@ -418,17 +580,129 @@ export class ClangASTParser {
         }
 
         try {
-          // Parse JSON output from cfg-exporter
-          console.log('cfg-exporter output length:', output.length);
-          console.log('cfg-exporter output preview:', output.substring(0, 300));
-          
-          const jsonOutput = JSON.parse(output);
+          // Decode MessagePack output from cfg-exporter
+          console.log('cfg-exporter output length:', outputSize);
+
+          const jsonOutput = new InternedStringTable().resolveRecord(decodeMessagePack(Buffer.concat(chunks, outputSize)));
           const cfgData = this.parseCFGExporterJSON(jsonOutput, filePath);
           console.log('Parsed CFG with', cfgData ? Object.keys(cfgData.inner || {}).length : 0, 'functions');
           resolve(cfgData);
         } catch (parseError: any) {
-          reject(new Error(`Failed to parse cfg-exporter JSON output: ${parseError.message}`));
+          reject(new Error(`Failed to decode cfg-exporter output: ${parseError.message}`));
+        }
+      });
+
+      child.on('error', (error) => {
+        reject(new Error(`Failed to spawn cfg-exporter: ${error.message}`));
+      });
+    });
+  }
+
+  /**
+   * Parse many files with one `cfg-exporter --batch` run.
+   *
+   * The exporter processes translation units on worker threads and streams one
+   * MessagePack record per function; functions are converted as they arrive and onFile is
+   * invoked when a file's "done" (or "error") line is read, in completion order
+   * (not input order). With headerFunctions, functions defined in project headers
+   * are reported per header once the run has finished.
+   *
+   * @param filePaths - Source files to parse
+   * @param onFile - Receives the AST (or error) of each file
+   * @param options - Compilation database and worker count
+   * @throws Error if the exporter cannot run at all
+   */
+  async parseFilesBatch(filePaths: string[], onFile: BatchFileCallback, options: BatchParseOptions = {}): Promise<void> {
+    if (!this.clangPath) {
+      throw new Error('Clang is not available');
+    }
+
+    const exporterPath = this.findExporter();
+    // Only main-file CFGs are used: header function bodies need not be parsed
+    const batchArgs = ['--batch', '--stream', '--format=msgpack', '--skip-header-bodies', '--top-level-statements', '--intern-strings'];
+    if (options.compileCommandsPath) {
+      batchArgs.push(`--compile-commands=${options.compileCommandsPath}`);
+    }
+    if (options.jobs) {
+      batchArgs.push('-j', String(options.jobs));
+    }
+    if (options.simplifyCFG) {
+      batchArgs.push('--simplify-cfg');
+    }
+    if (options.taintSpec) {
+      batchArgs.push(`--taint-spec=${options.taintSpec}`);
+    }
+    if (options.headerFunctions) {
+      batchArgs.push('--header-functions');
+    }
+    batchArgs.push(...filePaths);
+
+    return new Promise((resolve, reject) => {
+      const child = child_process.spawn(exporterPath, batchArgs);
+      const decoder = new MessagePackStreamDecoder();
+      // One string table spans all records of the run
+      const strings = new InternedStringTable();
+      let errorOutput = '';
+      let reported = 0;
+      // Functions received so far for files that are still being exported
+      const inProgress = new Map<string, ASTNode[]>();
+      // Functions defined in project headers, by header (the exporter reports
+      // its real path); each arrives once, in the stream of whichever
+      // translation unit exported it first
+      const headerFunctions = new Map<string, ASTNode[]>();
+
+      const handleRecord = (record: any) => {
+        if (record.function) {
+          const owner = record.function.header ? headerFunctions : inProgress;
+          const file = record.function.header ? path.resolve(record.function.file) : record.file;
+          let functions = owner.get(file);
+          if (!functions) {
+            functions = [];
+            owner.set(file, functions);
+          }
+          this.addExportedFunction(functions, record.function);
+          return;
+        }
+
+        reported++;
+        const functions = inProgress.get(record.file) || [];
+        inProgress.delete(record.file);
+        if (record.error) {
+          onFile(record.file, null, new Error(`cfg-exporter: ${record.error}`));
+        } else {
+          onFile(record.file, { kind: 'TranslationUnit', inner: this.keyFunctions(functions), globals: record.globals });
         }
+      };
+
+      child.stdout.on('data', (data: Buffer) => {
+        let records: any[];
+        try {
+          records = decoder.push(data).map(record => strings.resolveRecord(record));
+        } catch (decodeError: any) {
+          console.error('Malformed cfg-exporter batch output:', decodeError.message);
+          child.kill();
+          return;
+        }
+        records.forEach(handleRecord);
+      });
+
+      child.stderr.on('data', (data: Buffer) => {
+        errorOutput += data.toString();
+      });
+
+      child.on('close', (code) => {
+        if (decoder.pendingBytes > 0) {
+          console.error(`cfg-exporter --batch output ended inside a record (${decoder.pendingBytes} bytes)`);
+        }
+        if (code !== 0 && reported === 0) {
+          reject(new Error(`cfg-exporter --batch exited with code ${code}: ${errorOutput}`));
+          return;
+        }
+        headerFunctions.forEach((functions, headerFile) => {
+          onFile(headerFile, { kind: 'TranslationUnit', inner: this.keyFunctions(functions), globals: [] });
+        });
+        console.log(`cfg-exporter --batch reported ${reported} of ${filePaths.length} files`);
+        resolve();
       });
 
       child.on('error', (error) => {
@@ -437,6 +711,31 @@ export class ClangASTParser {
     });
   }
 
+  /**
+   * Release the AST and preamble the exporter server keeps for a file
+   * parsed with keepAlive (e.g. when its editor is closed)
+   */
+  async closeFile(filePath: string): Promise<void> {
+    if (!this.exporterClient || !this.exporterClient.isRunning()) {
+      return;
+    }
+    try {
+      await this.exporterClient.request('close', { file: filePath });
+    } catch (error: any) {
+      console.warn(`Failed to close ${filePath} in cfg-exporter server:`, error.message);
+    }
+  }
+
+  /**
+   * Stop the persistent exporter server, if one is running
+   */
+  dispose(): void {
+    if (this.exporterClient) {
+      this.exporterClient.dispose();
+      this.exporterClient = null;
+    }
+  }
+
   /**
    * Parse cfg-exporter JSON output into AST-like structure
    * The exporter provides clean, structured JSON with functions and their CFG blocks
@@ -447,60 +746,17 @@ export class ClangASTParser {
         return null;
       }
 
-      const functions: { [name: string]: ASTNode } = {};
+      const functions: ASTNode[] = [];
 
       for (const funcData of jsonData.functions) {
-        const funcName = funcData.name || 'unknown';
-        const blocks: ASTNode[] = [];
-
-        // Convert each block from the JSON
-        for (const blockData of (funcData.blocks || [])) {
-          const block: ASTNode = {
-            kind: 'CFGBlock',
-            name: blockData.label || `B${blockData.id}`,
-            id: String(blockData.id),
-            label: blockData.label,
-            isEntry: blockData.isEntry || false,
-            isExit: blockData.isExit || false,
-            successors: blockData.successors ? blockData.successors.map(String) : [],
-            predecessors: blockData.predecessors ? blockData.predecessors.map(String) : [],
-            statements: []
-          };
-
-          // Convert statements from the JSON
-          for (const stmtData of (blockData.statements || [])) {
-            const stmtText = stmtData.text || '';
-            // Detect function calls using CFG-aware extraction
-            const hasFunctionCall = this.detectFunctionCallInStatement(stmtText);
-            
-            const stmt: Statement = {
-              text: stmtText,
-              content: stmtText, // Alias for compatibility
-              type: hasFunctionCall ? StatementType.FUNCTION_CALL : undefined,
-              range: this.convertSourceRange(stmtData.range) || {
-                start: { line: 0, column: 0 },
-                end: { line: 0, column: 0 }
-              }
-            };
-            block.statements!.push(stmt);
-          }
-
-          blocks.push(block);
-        }
-
-        // Create function node
-        functions[funcName] = {
-          kind: 'FunctionDecl',
-          name: funcName,
-          inner: blocks,
-          range: funcData.range ? this.convertSourceRange(funcData.range) : undefined
-        };
+        this.addExportedFunction(functions, funcData);
       }
 
       // Return root node with functions as inner property
       return {
         kind: 'TranslationUnit',
-        inner: functions
+        inner: this.keyFunctions(functions),
+        globals: jsonData.globals
       };
     } catch (error: any) {
       console.error('Error parsing cfg-exporter JSON:', error.message);
@@ -508,6 +764,189 @@ export class ClangASTParser {
     }
   }
 
+  /**
+   * Key converted functions by name once all functions of a file are known.
+   * A name defined once is its own key. Overloads and same-named methods are
+   * all keyed by their parameter types, or by USR where the types do not
+   * tell them apart either, so keys do not depend on definition order.
+   */
+  private keyFunctions(functions: ASTNode[]): { [name: string]: ASTNode } {
+    const byName = new Map<string, ASTNode[]>();
+    for (const func of functions) {
+      const name = func.name || 'unknown';
+      const sameName = byName.get(name);
+      if (sameName) {
+        sameName.push(func);
+      } else {
+        byName.set(name, [func]);
+      }
+    }
+
+    const keyed: { [name: string]: ASTNode } = {};
+    byName.forEach((sameName, name) => {
+      if (sameName.length === 1) {
+        keyed[name] = sameName[0];
+        return;
+      }
+      const typedKeys = sameName.map(func =>
+        `${name}(${(func.signature?.parameters || []).map(param => param.type).join(', ')})`);
+      sameName.forEach((func, index) => {
+        const typedKey = typedKeys[index];
+        const ambiguous = typedKeys.indexOf(typedKey) !== typedKeys.lastIndexOf(typedKey);
+        const key = !ambiguous ? typedKey : func.usr || `${typedKey}@${func.range?.start.line ?? index}`;
+        func.name = key;
+        keyed[key] = func;
+      });
+    });
+    return keyed;
+  }
+
+  /**
+   * Convert one exported function record (with its CFG blocks) and append it
+   * to functions (see keyFunctions). Used for whole documents and for
+   * streamed records.
+   *
+   * @returns The added function node
+   */
+  private addExportedFunction(functions: ASTNode[], funcData: any): ASTNode {
+    const funcName = funcData.name || 'unknown';
+    const blocks: ASTNode[] = [];
+    const variableTable: ExportedVariable[] | undefined = funcData.variables;
+    const variableNames = new Map<number, string>();
+    for (const variable of (variableTable || [])) {
+      variableNames.set(variable.id, variable.name);
+    }
+
+    // Convert each block from the JSON
+    for (const blockData of (funcData.blocks || [])) {
+      const block: ASTNode = {
+        kind: 'CFGBlock',
+        name: blockData.label || `B${blockData.id}`,
+        id: String(blockData.id),
+        label: blockData.label,
+        isEntry: blockData.isEntry || false,
+        isExit: blockData.isExit || false,
+        successors: blockData.successors ? blockData.successors.map(String) : [],
+        infeasibleSuccessors: blockData.infeasibleSuccessors ? blockData.infeasibleSuccessors.map(String) : undefined,
+        predecessors: blockData.predecessors ? blockData.predecessors.map(String) : [],
+        immediateDominator: blockData.immediateDominator != null ? String(blockData.immediateDominator) : undefined,
+        immediatePostDominator: blockData.immediatePostDominator != null ? String(blockData.immediatePostDominator) : undefined,
+        controlDependencies: blockData.controlDependencies ? blockData.controlDependencies.map(String) : undefined,
+        rpo: blockData.rpo ?? undefined,
+        postorder: blockData.postorder ?? undefined,
+        backEdges: blockData.backEdges ? blockData.backEdges.map(String) : undefined,
+        loopHeader: blockData.loopHeader != null ? String(blockData.loopHeader) : undefined,
+        loopDepth: blockData.loopDepth,
+        mergedBlocks: blockData.mergedBlocks ? blockData.mergedBlocks.map(String) : undefined,
+        statements: []
+      };
+
+      // Convert statements from the JSON
+      for (const stmtData of (blockData.statements || [])) {
+        const stmtText = stmtData.text || '';
+        // Detect function calls using CFG-aware extraction
+        const hasFunctionCall = this.detectFunctionCallInStatement(stmtText);
+        
+        const stmt: Statement = {
+          id: stmtData.id,
+          text: stmtText,
+          content: stmtText, // Alias for compatibility
+          type: hasFunctionCall ? StatementType.FUNCTION_CALL : undefined,
+          range: this.convertSourceRange(stmtData.range) || {
+            start: { line: 0, column: 0 },
+            end: { line: 0, column: 0 }
+          }
+        };
+
+        // DEF/USE sets from the AST; statements without them fall back to
+        // the text-based analysis in DataflowAnalyzer
+        if (variableTable && Array.isArray(stmtData.defs) && Array.isArray(stmtData.uses)) {
+          stmt.variableIds = { defined: stmtData.defs, used: stmtData.uses };
+          stmt.variables = {
+            defined: stmtData.defs.map((id: number) => variableNames.get(id) || `v${id}`),
+            used: stmtData.uses.map((id: number) => variableNames.get(id) || `v${id}`)
+          };
+        }
+        if (Array.isArray(stmtData.defPaths) && Array.isArray(stmtData.usePaths)) {
+          stmt.accessPaths = {
+            defined: stmtData.defPaths.map((data: any) => this.convertAccessPath(data, variableNames)),
+            used: stmtData.usePaths.map((data: any) => this.convertAccessPath(data, variableNames))
+          };
+        }
+        block.statements!.push(stmt);
+      }
+
+      if (Array.isArray(blockData.calls)) {
+        const names = (ids: number[] | undefined) => (ids || []).map(id => variableNames.get(id) || `v${id}`);
+        block.callSites = blockData.calls.map((callData: any): CallSite => ({
+          statementId: callData.statement,
+          callee: callData.callee ?? null,
+          name: callData.name || '',
+          usr: callData.usr,
+          range: this.convertSourceRange(callData.range),
+          arguments: (callData.arguments || []).map((arg: any) => ({
+            text: arg.text || '',
+            type: arg.type || 'auto',
+            defined: names(arg.defs),
+            used: names(arg.uses)
+          })),
+          returnUsed: callData.returnUsed !== false,
+          assignedTo: typeof callData.assignedTo === 'number' ? variableNames.get(callData.assignedTo) : undefined,
+          taint: Array.isArray(callData.taint)
+            ? callData.taint.map((tag: any) => ({
+                role: tag.role,
+                entry: tag.entry,
+                category: tag.category,
+                arguments: tag.arguments || [],
+                target: typeof tag.target === 'number' ? variableNames.get(tag.target) : undefined
+              }))
+            : undefined
+        }));
+      }
+
+      if (blockData.terminator !== undefined) {
+        const terminatorData = blockData.terminator;
+        const condition = terminatorData?.condition;
+        block.terminator = terminatorData === null ? null : {
+          kind: terminatorData.kind,
+          condition: condition
+            ? {
+                text: condition.text || '',
+                statementId: condition.statement ?? undefined,
+                used: (condition.uses || []).map((id: number) => variableNames.get(id) || `v${id}`),
+                constant: condition.constant ?? undefined
+              }
+            : null,
+          trueSuccessor: terminatorData.trueSuccessor != null ? String(terminatorData.trueSuccessor) : undefined,
+          falseSuccessor: terminatorData.falseSuccessor != null ? String(terminatorData.falseSuccessor) : undefined
+        };
+      }
+
+      blocks.push(block);
+    }
+
+    // Create function node
+    const func: ASTNode = {
+      kind: 'FunctionDecl',
+      name: funcName,
+      inner: blocks,
+      range: funcData.range ? this.convertSourceRange(funcData.range) : undefined,
+      variableTable,
+      signature: funcData.signature,
+      usr: funcData.usr ?? undefined,
+      bodyHash: funcData.hash || undefined,
+      globalAccess: Array.isArray(funcData.globalReads) && Array.isArray(funcData.globalWrites)
+        ? {
+            reads: funcData.globalReads.map((id: number) => variableNames.get(id) || `v${id}`),
+            writes: funcData.globalWrites.map((id: number) => variableNames.get(id) || `v${id}`)
+          }
+        : undefined,
+      taintTagged: funcData.taintTagged === true || undefined
+    };
+    functions.push(func);
+    return func;
+  }
+
   /**
    * Detect if a statement contains a function call
    * Uses CFG-aware extraction instead of regex
@@ -520,6 +959,29 @@ export class ClangASTParser {
     return FunctionCallExtractor.hasFunctionCall(tempStmt);
   }
 
+  /**
+   * Convert a cfg-exporter access path, spelling its key once here so that
+   * analyzers compare paths without re-parsing names
+   */
+  private convertAccessPath(data: any, variableNames: Map<number, string>): AccessPath {
+    const base = variableNames.get(data.base) || `v${data.base}`;
+    const steps: AccessStep[] = data.steps || [];
+    let key = base;
+    for (let i = 0; i < steps.length; i++) {
+      const step = steps[i];
+      if (step.kind === 'deref' && steps[i + 1]?.kind === 'field') {
+        key += `->${steps[++i].name}`;
+      } else if (step.kind === 'deref') {
+        key = `(*${key})`;
+      } else if (step.kind === 'field') {
+        key += `.${step.name}`;
+      } else {
+        key += `[${step.index ?? '*'}]`;
+      }
+    }
+    return { base, steps, key };
+  }
+
   /**
    * Convert cfg-exporter source range to internal Range format
    */
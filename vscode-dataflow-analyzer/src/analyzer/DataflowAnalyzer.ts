@@ -75,7 +75,7 @@
 import * as vscode from 'vscode';
 import * as path from 'path';
 import * as fs from 'fs';
-import { EnhancedCPPParser } from './EnhancedCPPParser';
+import { EnhancedCPPParser, FunctionInfo } from './EnhancedCPPParser';
 import { LivenessAnalyzer } from './LivenessAnalyzer';
 import { ReachingDefinitionsAnalyzer } from './ReachingDefinitionsAnalyzer';
 import { TaintAnalyzer } from './TaintAnalyzer';
@@ -86,12 +86,17 @@ import { InterProceduralTaintAnalyzer } from './InterProceduralTaintAnalyzer';
 import { ParameterAnalyzer } from './ParameterAnalyzer';
 import { ReturnValueAnalyzer } from './ReturnValueAnalyzer';
 import { FunctionCallExtractor } from './FunctionCallExtractor';
+import { writeTaintRegistrySpec } from './TaintRegistrySpec';
+import { defaultTaintSourceRegistry } from './TaintSourceRegistry';
+import { defaultTaintSinkRegistry } from './TaintSinkRegistry';
+import { defaultSanitizationRegistry } from './SanitizationRegistry';
 import { StateManager } from '../state/StateManager';
 import { LoggingConfig } from '../utils/LoggingConfig';
 import { CFGVisualizer } from '../visualizer/CFGVisualizer';
 import {
   CFG,
   FunctionCFG,
+  LivenessInfo,
   AnalysisState,
   FileAnalysisState,
   AnalysisConfig,
@@ -137,6 +142,14 @@ export class DataflowAnalyzer {
   // Current analysis results cached in memory
   private currentState: AnalysisState | null = null;
 
+  // Analysis settings currentState's per-function results were computed
+  // with; results are only reused while the configuration still matches
+  private resultsConfigKey: string;
+
+  // Registry spec passed to the exporter so call sites arrive tagged with
+  // their taint role (null: not written, or registries need text matching)
+  private taintSpecPath?: string | null;
+
   // CRITICAL FIX (LOGIC.md #4): Mutex to prevent race conditions in concurrent file updates
   // Serializes updateFile calls to prevent state corruption
   private updateMutex: Promise<void> = Promise.resolve();
@@ -161,6 +174,7 @@ export class DataflowAnalyzer {
     this.securityAnalyzer = new SecurityAnalyzer();
     this.stateManager = new StateManager(workspacePath);
     this.config = config;
+    this.resultsConfigKey = this.getResultsConfigKey();
     
     // Load existing state from disk, or create empty state if none exists
     const loadResult = this.stateManager.loadState();
@@ -234,8 +248,42 @@ export class DataflowAnalyzer {
     // STEP 1: Find all C++ files in workspace
     const cppFiles = await this.findCppFiles(workspacePath);
     
-    // STEP 2: Parse each file and extract CFGs
+    // STEP 2: Parse all files and extract CFGs
+    // One batched exporter run processes the translation units on worker threads
+    // (using compile_commands.json flags when the workspace has one); each file's
+    // CFGs are added as soon as the exporter reports it
+    // Input path of each file by resolved path (the exporter reports absolute paths)
+    const inputPaths = new Map(cppFiles.map(filePath => [path.resolve(filePath), filePath]));
+    const pendingFiles = new Set(inputPaths.keys());
+    try {
+      await this.parser.parseFiles(cppFiles, (filePath, parsed, error) => {
+        const resolvedPath = path.resolve(filePath);
+        const inputPath = inputPaths.get(resolvedPath) || filePath;
+        pendingFiles.delete(resolvedPath);
+        if (!parsed) {
+          console.error(`Error analyzing ${inputPath}:`, error);
+          return;
+        }
+        try {
+          fileStates.set(inputPath, this.addParsedFunctions(inputPath, cfg, parsed.functions));
+        } catch (addError) {
+          console.error(`Error analyzing ${inputPath}:`, addError);
+        }
+      }, {
+        compileCommandsPath: this.findCompileCommands(workspacePath),
+        simplifyCFG: this.config.simplifyCFG,
+        taintSpec: this.getTaintSpecPath(),
+        headerFunctions: this.config.analyzeHeaderFunctions === true
+      });
+    } catch (batchError) {
+      console.warn('Batch parsing failed, analyzing files one at a time:', batchError);
+    }
+
+    // Files the batch run did not report (or all of them, if it failed) go through the per-file path
     for (const filePath of cppFiles) {
+      if (!pendingFiles.has(path.resolve(filePath))) {
+        continue;
+      }
       try {
         const fileState = await this.analyzeFile(filePath, cfg);
         fileStates.set(filePath, fileState);
@@ -882,6 +930,7 @@ export class DataflowAnalyzer {
       // CRITICAL FIX: Set taintSensitivity from config
       taintSensitivity: currentSensitivity
     };
+    this.resultsConfigKey = this.getResultsConfigKey();
 
     // Prepare all visualization data in backend (before saving state)
     console.log('[DataflowAnalyzer] Preparing all visualization data in backend...');
@@ -1540,6 +1589,7 @@ export class DataflowAnalyzer {
       // CRITICAL FIX: Set taintSensitivity from config (was missing!)
       taintSensitivity: this.config.taintSensitivity || TaintSensitivity.PRECISE
     };
+    this.resultsConfigKey = this.getResultsConfigKey();
 
     // Prepare all visualization data in backend (before saving state)
     console.log('[DataflowAnalyzer] Preparing all visualization data in backend (analyzeSpecificFiles)...');
@@ -1559,17 +1609,63 @@ export class DataflowAnalyzer {
 
   /**
    * Analyze a single file
+   *
+   * @param contents - Unsaved editor contents to analyze instead of the file on disk
+   * @param onFunction - Receives each function as soon as the exporter streams it
+   */
+  private async analyzeFile(
+    filePath: string,
+    cfg: CFG,
+    contents?: string,
+    onFunction?: (func: FunctionInfo) => void
+  ): Promise<FileAnalysisState> {
+    console.log(`Analyzing file: ${filePath}`);
+
+    // Keystroke mode re-parses the same file on every debounced edit: keep its
+    // AST and precompiled preamble alive in the exporter between updates
+    const { functions, globalVars } = await this.parser.parseFile(filePath, {
+      keepAlive: this.config.updateMode === 'keystroke',
+      simplifyCFG: this.config.simplifyCFG,
+      taintSpec: this.getTaintSpecPath(),
+      contents
+    }, onFunction);
+    return this.addParsedFunctions(filePath, cfg, functions, contents);
+  }
+
+  /**
+   * Path of the taint registry spec for the exporter, written on first use;
+   * undefined when taint analysis is off or the spec cannot be written
    */
-  private async analyzeFile(filePath: string, cfg: CFG): Promise<FileAnalysisState> {
-    const hash = this.stateManager.computeFileHash(filePath);
+  private getTaintSpecPath(): string | undefined {
+    if (!this.config.enableTaintAnalysis) {
+      return undefined;
+    }
+    if (this.taintSpecPath === undefined) {
+      try {
+        this.taintSpecPath = writeTaintRegistrySpec(
+          defaultTaintSourceRegistry,
+          defaultTaintSinkRegistry,
+          defaultSanitizationRegistry
+        ) ?? null;
+      } catch (error) {
+        console.warn('Could not write taint registry spec, classifying calls by text:', error);
+        this.taintSpecPath = null;
+      }
+    }
+    return this.taintSpecPath ?? undefined;
+  }
+
+  /**
+   * Add the parsed functions of one file to the CFG and record the file's state
+   */
+  private addParsedFunctions(filePath: string, cfg: CFG, functions: FunctionInfo[], contents?: string): FileAnalysisState {
+    const hash = this.stateManager.computeFileHash(filePath, contents);
     const stats = fs.statSync(filePath);
 
-    console.log(`Analyzing file: ${filePath}`);
     const normalizedSourcePath = path.resolve(filePath);
     const sourceFileBase = path.basename(filePath);
     const sourceFileDir = path.dirname(filePath);
     
-    const { functions, globalVars } = await this.parser.parseFile(filePath);
     console.log(`Parser returned ${functions.length} functions from ${filePath}`);
 
     const functionNames: string[] = [];
@@ -1668,10 +1764,22 @@ export class DataflowAnalyzer {
       if (funcInfo.cfg) {
         // Populate variable information for statements in the CFG
         this.populateStatementVariables(funcInfo.cfg);
-        cfg.functions.set(funcInfo.name, funcInfo.cfg);
-        functionNames.push(funcInfo.name);
+        // A function of another file (e.g. a static function, or one without
+        // a USR) is already keyed by this name: qualify this one by file.
+        // Keys are unique within a file, and the file's previous functions
+        // were removed before it was re-parsed
+        let funcKey = funcInfo.name;
+        if (cfg.functions.has(funcKey)) {
+          funcKey = `${funcInfo.name} [${sourceFileBase}]`;
+          if (cfg.functions.has(funcKey)) {
+            funcKey = `${funcInfo.name} [${normalizedSourcePath}]`;
+          }
+          funcInfo.cfg.name = funcKey;
+        }
+        cfg.functions.set(funcKey, funcInfo.cfg);
+        functionNames.push(funcKey);
         addedCount++;
-        console.log(`✓ Added function to CFG: ${funcInfo.name} (from ${filePath}, ${funcInfo.cfg.blocks.size} blocks)`);
+        console.log(`✓ Added function to CFG: ${funcKey} (from ${filePath}, ${funcInfo.cfg.blocks.size} blocks)`);
       } else {
         console.warn(`Function ${funcInfo.name} has no CFG - skipping`);
         skippedCount++;
@@ -1701,14 +1809,16 @@ export class DataflowAnalyzer {
    * to prevent state corruption.
    * 
    * @param filePath - Absolute path to the file to update
+   * @param contents - Unsaved editor contents (keystroke mode); when omitted
+   *                   the file is read from disk
    */
-  async updateFile(filePath: string): Promise<void> {
+  async updateFile(filePath: string, contents?: string): Promise<void> {
     // CRITICAL FIX (LOGIC.md #4): Acquire mutex to serialize concurrent updates
     // Chain the current operation after the previous one completes
     this.updateMutex = this.updateMutex.then(async () => {
       try {
         console.log(`[DataflowAnalyzer] updateFile mutex acquired for: ${filePath}`);
-        await this.updateFileInternal(filePath);
+        await this.updateFileInternal(filePath, contents);
         console.log(`[DataflowAnalyzer] updateFile mutex released for: ${filePath}`);
       } catch (error) {
         console.error(`[DataflowAnalyzer] Error in updateFile for ${filePath}:`, error);
@@ -1724,14 +1834,15 @@ export class DataflowAnalyzer {
    * Internal implementation of updateFile (protected by mutex)
    * 
    * @param filePath - Absolute path to the file to update
+   * @param contents - Unsaved editor contents, if any
    */
-  private async updateFileInternal(filePath: string): Promise<void> {
+  private async updateFileInternal(filePath: string, contents?: string): Promise<void> {
     if (!this.currentState) {
       await this.analyzeWorkspace();
       return;
     }
 
-    const newHash = this.stateManager.computeFileHash(filePath);
+    const newHash = this.stateManager.computeFileHash(filePath, contents);
     const existingState = this.currentState.fileStates.get(filePath);
 
     // INCREMENTAL ANALYSIS: Check if file actually changed using hash comparison
@@ -1751,26 +1862,86 @@ export class DataflowAnalyzer {
     }
 
     // Remove old function CFGs from this file
+    const previousCFGs = new Map<string, FunctionCFG>();
     if (existingState) {
       existingState.functions.forEach((funcName: string) => {
+        const previousCFG = this.currentState!.cfg.functions.get(funcName);
+        if (previousCFG) {
+          previousCFGs.set(funcName, previousCFG);
+        }
         this.currentState!.cfg.functions.delete(funcName);
       });
     }
 
-    // Re-analyze file
-    const fileState = await this.analyzeFile(filePath, this.currentState.cfg);
+    // Re-analyze file. Liveness and reaching definitions of changed functions
+    // are computed as the exporter streams each function, while it is still
+    // exporting the rest of the file; they do not depend on the function's key
+    const canReuse = this.resultsConfigKey === this.getResultsConfigKey();
+    const previousHashes = new Set(Array.from(previousCFGs.values(), previousCFG => `${previousCFG.usr}#${previousCFG.bodyHash}`));
+    const streamedResults = new Map<FunctionCFG, {
+      liveness?: Map<string, LivenessInfo>;
+      reachingDefinitions?: Map<string, ReachingDefinitionsInfo>;
+    }>();
+    const fileState = await this.analyzeFile(filePath, this.currentState.cfg, contents, (funcInfo) => {
+      const funcCFG = funcInfo.cfg;
+      if (canReuse && funcCFG.usr && funcCFG.bodyHash && previousHashes.has(`${funcCFG.usr}#${funcCFG.bodyHash}`)) {
+        return;
+      }
+      this.populateStatementVariables(funcCFG);
+      streamedResults.set(funcCFG, {
+        liveness: this.config.enableLiveness ? this.livenessAnalyzer.analyze(funcCFG) : undefined,
+        reachingDefinitions: this.config.enableReachingDefinitions
+          ? this.reachingDefinitionsAnalyzer.analyze(funcCFG)
+          : undefined
+      });
+    });
     this.currentState.fileStates.set(filePath, fileState);
 
-    // Re-run analyses for affected functions
+    // Re-run analyses for affected functions: functions of other files and
+    // functions of this file whose USR and record hash are unchanged (the
+    // exporter hashes the exported record and the declarations the body
+    // uses, so macro, callee and type changes count) keep their results, as
+    // long as the analysis settings are the same. The record includes source
+    // positions, which results carry too: functions moved by lines inserted
+    // or removed above them are re-analyzed
+    const previousState = this.currentState;
+    const changedFunctions = new Set(fileState.functions.filter(funcName => {
+      const previousCFG = previousCFGs.get(funcName);
+      const funcCFG = previousState.cfg.functions.get(funcName)!;
+      return !previousCFG || !previousCFG.bodyHash ||
+        previousCFG.bodyHash !== funcCFG.bodyHash || previousCFG.usr !== funcCFG.usr;
+    }));
     const liveness = new Map();
     const reachingDefinitions = new Map();
     const taintAnalysis = new Map();
     const vulnerabilities = new Map<string, any[]>();
+    let reusedCount = 0;
 
     this.currentState.cfg.functions.forEach((funcCFG: FunctionCFG, funcName: string) => {
+      if (canReuse && !changedFunctions.has(funcName)) {
+        funcCFG.blocks.forEach((_block, blockId) => {
+          const key = `${funcName}_${blockId}`;
+          if (previousState.liveness.has(key)) {
+            liveness.set(key, previousState.liveness.get(key));
+          }
+          if (previousState.reachingDefinitions.has(key)) {
+            reachingDefinitions.set(key, previousState.reachingDefinitions.get(key));
+          }
+        });
+        if (previousState.taintAnalysis.has(funcName)) {
+          taintAnalysis.set(funcName, previousState.taintAnalysis.get(funcName));
+        }
+        if (previousState.vulnerabilities.has(funcName)) {
+          vulnerabilities.set(funcName, previousState.vulnerabilities.get(funcName)!);
+        }
+        reusedCount++;
+        return;
+      }
+
+      const streamed = streamedResults.get(funcCFG);
       if (this.config.enableLiveness) {
         console.log(`Running liveness analysis for ${funcName} with ${funcCFG.blocks.size} blocks`);
-        const funcLiveness = this.livenessAnalyzer.analyze(funcCFG);
+        const funcLiveness = streamed?.liveness || this.livenessAnalyzer.analyze(funcCFG);
         console.log(`Liveness analysis for ${funcName} produced ${funcLiveness.size} entries`);
         funcLiveness.forEach((info, blockId) => {
           const key = `${funcName}_${blockId}`;
@@ -1780,7 +1951,7 @@ export class DataflowAnalyzer {
       }
 
       if (this.config.enableReachingDefinitions) {
-        const funcRD = this.reachingDefinitionsAnalyzer.analyze(funcCFG);
+        const funcRD = streamed?.reachingDefinitions || this.reachingDefinitionsAnalyzer.analyze(funcCFG);
         funcRD.forEach((info, blockId) => {
           reachingDefinitions.set(`${funcName}_${blockId}`, info);
         });
@@ -1869,11 +2040,14 @@ export class DataflowAnalyzer {
       }
     });
 
+    console.log(`[DataflowAnalyzer] [INFO] [Incremental] Reused results of ${reusedCount} unchanged functions`);
+
     this.currentState.liveness = liveness;
     this.currentState.reachingDefinitions = reachingDefinitions;
     this.currentState.taintAnalysis = taintAnalysis;
     this.currentState.vulnerabilities = vulnerabilities;
     this.currentState.timestamp = Date.now();
+    this.resultsConfigKey = this.getResultsConfigKey();
 
     this.stateManager.saveState(this.currentState);
   }
@@ -1929,6 +2103,19 @@ export class DataflowAnalyzer {
     return files;
   }
 
+  /**
+   * Locate the workspace's compilation database, if any
+   *
+   * @returns Path to compile_commands.json, or undefined to use default flags
+   */
+  private findCompileCommands(workspacePath: string): string | undefined {
+    const candidates = [
+      path.join(workspacePath, 'compile_commands.json'),
+      path.join(workspacePath, 'build', 'compile_commands.json')
+    ];
+    return candidates.find(candidate => fs.existsSync(candidate));
+  }
+
   /**
    * Create empty state
    */
@@ -1971,6 +2158,9 @@ export class DataflowAnalyzer {
 
   /**
    * Populate variable information for statements in a CFG
+   *
+   * Statements exported by cfg-exporter already carry DEF/USE sets computed
+   * from the Clang AST; only statements without them use the text analysis.
    */
   private populateStatementVariables(funcCFG: FunctionCFG): void {
     funcCFG.blocks.forEach((block: any, blockId: string) => {
@@ -2187,6 +2377,20 @@ export class DataflowAnalyzer {
     }
   }
 
+  /**
+   * Settings that determine per-function CFGs and their liveness,
+   * reaching-definitions and taint results
+   */
+  private getResultsConfigKey(): string {
+    return JSON.stringify([
+      this.config.enableLiveness,
+      this.config.enableReachingDefinitions,
+      this.config.enableTaintAnalysis,
+      this.config.taintSensitivity || TaintSensitivity.PRECISE,
+      this.config.simplifyCFG === true
+    ]);
+  }
+
   /**
    * Update configuration
    */
@@ -2253,5 +2457,21 @@ export class DataflowAnalyzer {
   getConfig(): AnalysisConfig {
     return this.config;
   }
+
+  /**
+   * Release the exporter AST kept for a file (called when its editor closes)
+   *
+   * @param filePath - Absolute path to the closed file
+   */
+  async closeFile(filePath: string): Promise<void> {
+    await this.parser.closeFile(filePath);
+  }
+
+  /**
+   * Release parser resources (the persistent cfg-exporter server process)
+   */
+  dispose(): void {
+    this.parser.dispose();
+  }
 }
 
@@ -23,7 +23,8 @@
  *   2. Parses CFG blocks and their relationships (predecessors/successors)
  *   3. Extracts statements from each block
  *   4. Identifies entry/exit blocks using graph-theoretic properties
- *   5. Extracts function parameters from source code
+ *   5. Takes function parameters from the exported signature (from source
+ *      code for exporter output without one)
  *   6. Converts to FunctionCFG structure
  * 
  * OUTPUTS:
@@ -58,7 +59,7 @@
 import * as fs from 'fs';
 import * as path from 'path';
 import { Statement, StatementType, BasicBlock, CFG, FunctionCFG, Position, Range } from '../types';
-import { ClangASTParser } from './ClangASTParser';
+import { ClangASTParser, ParseOptions, BatchParseOptions } from './ClangASTParser';
 import { ASTNode, CXCursorKind } from './ClangASTParser';
 import { logError, logWarning, logInfo } from '../utils/ErrorLogger';
 
@@ -104,29 +105,88 @@ export class EnhancedCPPParser {
    * Parse a C++ source file and extract all functions.
    * 
    * @param filePath - Absolute path to C++ source file
+   * @param options - Parse options forwarded to ClangASTParser
+   * @param onFunction - Receives each function of a streamed export as soon as
+   *                     it arrives; the returned functions share its CFG
    * @returns Object containing array of functions and global variables
    * @throws Error if file cannot be parsed
    */
-  async parseFile(filePath: string): Promise<{ functions: FunctionInfo[]; globalVars: string[] }> {
-    return this.parseWithClangAST(filePath);
+  async parseFile(
+    filePath: string,
+    options: ParseOptions = {},
+    onFunction?: (func: FunctionInfo) => void
+  ): Promise<{ functions: FunctionInfo[]; globalVars: string[] }> {
+    return this.parseWithClangAST(filePath, options, onFunction);
+  }
+
+  /**
+   * Parse many files in one batched, multi-threaded exporter run.
+   *
+   * @param filePaths - Absolute paths to C++ source files
+   * @param onFile - Receives the extracted functions (or the error) of each file as it finishes
+   * @param options - Compilation database and worker count
+   * @throws Error if the batch exporter cannot run at all
+   */
+  async parseFiles(
+    filePaths: string[],
+    onFile: (filePath: string, parsed: { functions: FunctionInfo[]; globalVars: string[] } | null, error?: Error) => void,
+    options: BatchParseOptions = {}
+  ): Promise<void> {
+    await this.clangParser.parseFilesBatch(filePaths, (filePath, ast, error) => {
+      if (!ast) {
+        onFile(filePath, null, error || new Error(`Failed to parse ${filePath} with clang.`));
+        return;
+      }
+      onFile(filePath, this.extractFunctionsFromAST(ast, filePath));
+    }, options);
+  }
+
+  /**
+   * Release exporter resources kept for a file parsed with keepAlive.
+   *
+   * @param filePath - Absolute path to C++ source file
+   */
+  async closeFile(filePath: string): Promise<void> {
+    await this.clangParser.closeFile(filePath);
   }
 
   /**
    * Parse using clang's official AST/CFG generation.
    * 
    * @param filePath - Path to C++ source file
+   * @param options - Parse options forwarded to ClangASTParser
+   * @param onFunction - Receives each streamed function as it arrives
    * @returns Extracted functions and global variables
    * @throws Error if clang parsing fails
    */
-  private async parseWithClangAST(filePath: string): Promise<{ functions: FunctionInfo[]; globalVars: string[] }> {
+  private async parseWithClangAST(
+    filePath: string,
+    options: ParseOptions = {},
+    onFunction?: (func: FunctionInfo) => void
+  ): Promise<{ functions: FunctionInfo[]; globalVars: string[] }> {
+    // Functions converted while the export was streaming, by node
+    const streamed = new Map<ASTNode, FunctionCFG>();
+    const parseOptions: ParseOptions = onFunction
+      ? {
+          ...options,
+          onFunction: (funcNode) => {
+            const cfg = this.extractCFGFromFunctionNode(funcNode, filePath);
+            if (cfg) {
+              streamed.set(funcNode, cfg);
+              onFunction(this.createFunctionInfo(funcNode.name || cfg.name, funcNode, cfg));
+            }
+          }
+        }
+      : options;
+
     // STEP 1: Parse file with clang to generate CFG
-    const ast = await this.clangParser.parseFile(filePath);
+    const ast = await this.clangParser.parseFile(filePath, [], parseOptions);
     if (!ast) {
       throw new Error(`Failed to parse ${filePath} with clang. Please ensure clang is properly installed and the file is valid C++ code.`);
     }
 
     // STEP 2: Extract functions from CFG AST
-    return this.extractFunctionsFromAST(ast, filePath);
+    return this.extractFunctionsFromAST(ast, filePath, streamed);
   }
 
   /**
@@ -138,9 +198,14 @@ export class EnhancedCPPParser {
    * 
    * @param ast - AST from clang parser
    * @param filePath - Source file path
+   * @param converted - CFGs already extracted from some of the function nodes
    * @returns Functions and global variables extracted from AST
    */
-  private extractFunctionsFromAST(ast: ASTNode, filePath: string): { functions: FunctionInfo[]; globalVars: string[] } {
+  private extractFunctionsFromAST(
+    ast: ASTNode,
+    filePath: string,
+    converted?: Map<ASTNode, FunctionCFG>
+  ): { functions: FunctionInfo[]; globalVars: string[] } {
     const functions: FunctionInfo[] = [];
     const globalVars: string[] = [];
 
@@ -157,14 +222,11 @@ export class EnhancedCPPParser {
         console.log(`Found function: ${funcName}`);
 
         // STEP 3: Extract CFG blocks from function node
-        const cfg = this.extractCFGFromFunctionNode(funcNode, filePath);
+        const cfg = converted?.get(funcNode) || this.extractCFGFromFunctionNode(funcNode, filePath);
         if (cfg) {
-          const funcInfo: FunctionInfo = {
-            name: funcName,
-            range: funcNode.range || { start: { line: 1, column: 0 }, end: { line: 1, column: 0 } },
-            cfg: cfg,
-            astNode: funcNode
-          };
+          // Streamed functions were converted before overloads got their keys
+          cfg.name = funcName;
+          const funcInfo = this.createFunctionInfo(funcName, funcNode, cfg);
 
           functions.push(funcInfo);
           console.log(`✓ Extracted function: ${funcName} with ${cfg.blocks.size} blocks`);
@@ -172,10 +234,30 @@ export class EnhancedCPPParser {
       }
     }
 
+    // Shared globals from the exporter's per-file table (static locals are
+    // private to their function)
+    for (const global of ast.globals || []) {
+      if (global.kind !== 'static' && !globalVars.includes(global.name)) {
+        globalVars.push(global.name);
+      }
+    }
+
     console.log(`Extracted ${functions.length} functions from CFG structure`);
     return { functions, globalVars };
   }
 
+  /**
+   * FunctionInfo for an extracted function node
+   */
+  private createFunctionInfo(name: string, funcNode: ASTNode, cfg: FunctionCFG): FunctionInfo {
+    return {
+      name,
+      range: funcNode.range || { start: { line: 1, column: 0 }, end: { line: 1, column: 0 } },
+      cfg,
+      astNode: funcNode
+    };
+  }
+
   /**
    * Traverse CFG-based AST structure
    */
@@ -200,7 +282,8 @@ export class EnhancedCPPParser {
   /**
    * Extract function parameters from source code
    * 
-   * Since cfg-exporter doesn't provide parameter info, we parse it from source.
+   * Fallback for exporter output without a signature: parses the parameter
+   * list from source.
    * Looks for function signature: "returnType functionName(param1, param2, ...)"
    * 
    * CRITICAL FIX (LOGIC.md #7): Improved error handling to distinguish between
@@ -407,7 +490,19 @@ export class EnhancedCPPParser {
         label: blockNode.label || 'Unknown',
         statements: blockNode.statements || [],
         successors: blockNode.successors || [],
-        predecessors: blockNode.predecessors || []
+        infeasibleSuccessors: blockNode.infeasibleSuccessors,
+        predecessors: blockNode.predecessors || [],
+        callSites: blockNode.callSites,
+        terminator: blockNode.terminator,
+        immediateDominator: blockNode.immediateDominator,
+        immediatePostDominator: blockNode.immediatePostDominator,
+        controlDependencies: blockNode.controlDependencies,
+        rpo: blockNode.rpo,
+        postorder: blockNode.postorder,
+        backEdges: blockNode.backEdges,
+        loopHeader: blockNode.loopHeader,
+        loopDepth: blockNode.loopDepth,
+        mergedBlocks: blockNode.mergedBlocks
       };
 
       blocks.set(block.id, block);
@@ -460,9 +555,12 @@ export class EnhancedCPPParser {
       exitBlock = blockIds.length > 0 ? blockIds[blockIds.length - 1] : '';
     }
 
-    // Extract parameters from source code
+    // Parameters come with the exported signature; older exporter output
+    // needs them recovered from the source code
     const funcName = funcNode.name || 'unknown';
-    const parameters = filePath ? this.extractParametersFromSource(funcName, filePath) : [];
+    const parameters = funcNode.signature
+      ? funcNode.signature.parameters.map(param => param.name)
+      : (filePath ? this.extractParametersFromSource(funcName, filePath) : []);
 
     // Build the CFG structure
     const cfg: FunctionCFG = {
@@ -470,7 +568,13 @@ export class EnhancedCPPParser {
       entry: entryBlock || '',
       exit: exitBlock || '',
       blocks: blocks,
-      parameters: parameters // Extracted from source code
+      parameters: parameters,
+      usr: funcNode.usr,
+      bodyHash: funcNode.bodyHash,
+      variableTable: funcNode.variableTable,
+      signature: funcNode.signature,
+      globalAccess: funcNode.globalAccess,
+      taintTagged: funcNode.taintTagged
     };
 
     // CRITICAL FIX (LOGIC.md #14): Validate CFG structure before returning
@@ -571,6 +675,7 @@ export class EnhancedCPPParser {
    * Dispose of resources
    */
   dispose(): void {
-    // No resources to dispose for clang command-line approach
+    // Stop the persistent cfg-exporter server
+    this.clangParser.dispose();
   }
 }
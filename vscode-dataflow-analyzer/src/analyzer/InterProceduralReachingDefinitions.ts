@@ -17,7 +17,8 @@
  * 2. At each call site, propagate definitions from callee to caller
  * 3. Map formal parameters to actual arguments
  * 4. Propagate return values back to call sites
- * 5. Handle global variable definitions
+ * 5. Handle global variable definitions (with cfg-exporter mod sets: computed
+ *    once, bottom-up over the call graph's strongly connected components)
  * 6. Iterate until fixed point (no more changes)
  * 
  * Example:
@@ -89,6 +90,14 @@ export class InterProceduralReachingDefinitions {
   // Map: variableName -> ReachingDefinition[]
   private globalDefinitions: Map<string, ReachingDefinition[]>;
 
+  // Shared globals declared in the exported translation units
+  private globalNames: Set<string> = new Set();
+
+  // Definitions of globals that reach the exit of each function, including
+  // those made by its (transitive) callees. Map: funcId -> variable -> defs.
+  // Null when the CFGs carry no exported global mod sets.
+  private globalModDefinitions: Map<string, Map<string, ReachingDefinition[]>> | null = null;
+
   // Maximum iterations to prevent infinite loops
   private readonly MAX_ITERATIONS = 20;
 
@@ -159,11 +168,6 @@ export class InterProceduralReachingDefinitions {
         }
       }
 
-      // STEP 5: Propagate global variable changes
-      if (this.propagateGlobalVariables()) {
-        changed = true;
-      }
-
       console.log(`[IPA] Iteration ${iteration} complete. Changed: ${changed}`);
     }
 
@@ -184,13 +188,120 @@ export class InterProceduralReachingDefinitions {
    */
   private initializeGlobalVariables(): void {
     console.log('[IPA] Initializing global variable tracking');
+    this.globalDefinitions = new Map();
+
+    // Without exported global tables, globals are identified heuristically
+    // (isGlobalVariable) and propagated from callee exits during iteration
+    const functions = Array.from(this.callGraph.functions.values());
+    if (!functions.some(metadata => metadata.cfg.globalAccess)) {
+      return;
+    }
 
-    // For now, we'll identify globals heuristically
-    // In a full implementation, we'd parse global declarations from AST
-    // Common patterns: variables not in parameter lists, not local to any function
+    for (const metadata of functions) {
+      for (const variable of metadata.cfg.variableTable || []) {
+        if (variable.kind === 'global') {
+          this.globalNames.add(variable.name);
+        }
+      }
+    }
 
-    // This is a placeholder - full implementation would scan AST for global declarations
-    this.globalDefinitions = new Map();
+    this.globalModDefinitions = this.computeGlobalModDefinitions();
+    console.log(`[IPA] ${this.globalNames.size} globals, mod sets for ${this.globalModDefinitions.size} functions`);
+  }
+
+  /**
+   * Compute, for every function, the global definitions that may reach its
+   * exit: the ones it makes itself (its direct writes from the exporter) and
+   * the ones its callees make.
+   *
+   * One bottom-up pass: Tarjan's algorithm emits strongly connected
+   * components callees-first, and all functions of a component (mutual
+   * recursion) share one result.
+   *
+   * @returns Map funcId -> global variable -> definitions
+   */
+  private computeGlobalModDefinitions(): Map<string, Map<string, ReachingDefinition[]>> {
+    const result = new Map<string, Map<string, ReachingDefinition[]>>();
+    const index = new Map<string, number>();
+    const lowLink = new Map<string, number>();
+    const stack: string[] = [];
+    const onStack = new Set<string>();
+    let nextIndex = 0;
+
+    const callees = (funcId: string): string[] =>
+      (this.callGraph.callsFrom.get(funcId) || [])
+        .map(call => call.calleeId)
+        .filter(calleeId => this.callGraph.functions.has(calleeId));
+
+    const visit = (funcId: string): void => {
+      index.set(funcId, nextIndex);
+      lowLink.set(funcId, nextIndex);
+      nextIndex++;
+      stack.push(funcId);
+      onStack.add(funcId);
+
+      for (const calleeId of callees(funcId)) {
+        if (!index.has(calleeId)) {
+          visit(calleeId);
+          lowLink.set(funcId, Math.min(lowLink.get(funcId)!, lowLink.get(calleeId)!));
+        } else if (onStack.has(calleeId)) {
+          lowLink.set(funcId, Math.min(lowLink.get(funcId)!, index.get(calleeId)!));
+        }
+      }
+
+      if (lowLink.get(funcId) !== index.get(funcId)) {
+        return;
+      }
+
+      // funcId is the root of a component: pop it and merge its definitions
+      const component: string[] = [];
+      let member: string;
+      do {
+        member = stack.pop()!;
+        onStack.delete(member);
+        component.push(member);
+      } while (member !== funcId);
+
+      const defs = new Map<string, ReachingDefinition[]>();
+      const merge = (varName: string, newDefs: ReachingDefinition[]) => {
+        const existing = defs.get(varName) || [];
+        for (const def of newDefs) {
+          if (!existing.find(d => d.definitionId === def.definitionId)) {
+            existing.push(def);
+          }
+        }
+        defs.set(varName, existing);
+      };
+
+      for (const memberId of component) {
+        const metadata = this.callGraph.functions.get(memberId)!;
+        const exitRD = this.intraReachingDefs.get(memberId)?.get(metadata.cfg.exit);
+        for (const varName of metadata.cfg.globalAccess?.writes || []) {
+          const exitDefs = exitRD?.out.get(varName) || [];
+          merge(varName, exitDefs);
+          const allDefs = this.globalDefinitions.get(varName) || [];
+          this.globalDefinitions.set(varName, [...allDefs, ...exitDefs]);
+        }
+        for (const calleeId of callees(memberId)) {
+          // Callees in other components are finished already
+          for (const [varName, calleeDefs] of result.get(calleeId) || []) {
+            merge(varName, calleeDefs);
+          }
+        }
+      }
+
+      for (const memberId of component) {
+        result.set(memberId, defs);
+      }
+    };
+
+    for (const funcId of this.callGraph.functions.keys()) {
+      if (!index.has(funcId)) {
+        visit(funcId);
+      }
+    }
+
+    return result;
   }
 
   /**
@@ -517,8 +628,12 @@ export class InterProceduralReachingDefinitions {
     }
 
     // STEP 6: Propagate global variable definitions
-    // If callee modifies globals, propagate those changes back
-    for (const [varName, defs] of calleeExitRD.out.entries()) {
+    // If callee (or anything it calls) modifies globals, propagate those
+    // changes back. With exported mod sets these are precomputed.
+    const globalDefs = this.globalModDefinitions
+      ? (this.globalModDefinitions.get(calleeId) || new Map<string, ReachingDefinition[]>())
+      : calleeExitRD.out;
+    for (const [varName, defs] of globalDefs.entries()) {
       if (this.isGlobalVariable(varName)) {
         // This is a global variable modified by callee
         // Propagate to caller
@@ -596,10 +711,10 @@ export class InterProceduralReachingDefinitions {
   }
 
   /**
-   * Check if a variable is global (heuristic).
+   * Check if a variable is global.
    * 
-   * In a full implementation, this would check the AST for global declarations.
-   * For now, we use heuristics:
+   * Uses the global tables exported by cfg-exporter when present. Otherwise
+   * falls back to heuristics:
    * - Variables not in any function's parameter list
    * - Variables with uppercase names (common convention)
    * 
@@ -607,6 +722,11 @@ export class InterProceduralReachingDefinitions {
    * @returns true if variable appears to be global
    */
   private isGlobalVariable(varName: string): boolean {
+    // Exported global tables are exact
+    if (this.globalModDefinitions) {
+      return this.globalNames.has(varName);
+    }
+
     // Heuristic: check if variable is not a parameter of any function
     for (const metadata of this.callGraph.functions.values()) {
       if (metadata.parameters.some(p => p.name === varName)) {
@@ -622,38 +742,4 @@ export class InterProceduralReachingDefinitions {
     // For now, be conservative - don't assume globals
     return false;
   }
-
-  /**
-   * Propagate global variable definitions across all functions.
-   * 
-   * Global variables can be modified by any function, so changes to globals
-   * need to be propagated to all functions that use them.
-   * 
-   * @returns true if any definitions changed
-   */
-  private propagateGlobalVariables(): boolean {
-    // This is a simplified implementation
-    // Full implementation would track which functions modify which globals
-    // and only propagate to functions that use those globals
-
-    let changed = false;
-
-    // For each global definition
-    for (const [globalVar, defs] of this.globalDefinitions.entries()) {
-      // Propagate to all functions that might use this global
-      for (const [funcId, funcRD] of this.intraReachingDefs.entries()) {
-        // Check if function uses this global
-        for (const [blockId, rdInfo] of funcRD.entries()) {
-          // If block uses this global, add definitions
-          if (rdInfo.in.has(globalVar) || rdInfo.out.has(globalVar)) {
-            // Merge global definitions into function's IN/OUT sets
-            // (Simplified - full implementation would be more precise)
-          }
-        }
-      }
-    }
-
-    return changed;
-  }
 }
-
@@ -80,6 +80,7 @@ import { CallGraphAnalyzer, FunctionCall, CallGraph } from './CallGraphAnalyzer'
 import { ParameterAnalyzer, ParameterMapping, ArgumentDerivationType } from './ParameterAnalyzer';
 import { ReturnValueAnalyzer, ReturnValueInfo } from './ReturnValueAnalyzer';
 import { LoggingConfig } from '../utils/LoggingConfig';
+import { taintTypeFromDeclaredType } from './TaintSourceRegistry';
 
 /**
  * Taint summary for a library function.
@@ -444,14 +445,16 @@ export class InterProceduralTaintAnalyzer {
           variablesToCheck.has(t.variable)
         ) || combinedCallerTaint[0];
         
-        // Mark formal parameter as tainted in callee's entry block
+        // Mark formal parameter as tainted in callee's entry block. Its declared
+        // type (from the exported signature) decides the taint type when known.
+        const formalType = calleeMetadata.parameters.find(param => param.name === formalParam)?.type;
         const paramTaintTemplate: TaintInfo = {
           ...sourceTaint,
           variable: formalParam,
           source: `parameter:${formalParam}`,
           tainted: true,
           sourceCategory: sourceTaint.sourceCategory || 'user_input', // Inherit from caller
-          taintType: sourceTaint.taintType || 'string',
+          taintType: (formalType && taintTypeFromDeclaredType(formalType)) || sourceTaint.taintType || 'string',
           sourceFunction: callerName,
           propagationPath: [...(sourceTaint.propagationPath || []), calleeName],
           labels: sourceTaint.labels || [TaintLabel.DERIVED],
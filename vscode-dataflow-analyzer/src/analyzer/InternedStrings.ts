@@ -0,0 +1,79 @@
+/**
+ * InternedStrings.ts
+ *
+ * Reader side of cfg-exporter --intern-strings
+ *
+ * PURPOSE:
+ * With interning, the exporter writes file paths, statement texts, names and
+ * types once into a string table and every record refers to them by index.
+ * This module rebuilds the table from the records of one output stream and
+ * puts the strings back in place, so the rest of the pipeline sees the same
+ * objects as without interning. Repeated strings resolve to one shared
+ * string instead of one decoded copy per occurrence.
+ *
+ * DATA FLOW:
+ * INPUTS:
+ *   - Decoded exporter records (document, streamed function, batch line or
+ *     server frame), each carrying the strings it adds as `strings`
+ *
+ * OUTPUTS:
+ *   - The same records with interned fields resolved to strings
+ *
+ * LIMITATIONS:
+ *   - Records of one stream must be resolved in output order
+ */
+
+/**
+ * Fields whose string values cfg-exporter interns (StringTable::isInternedField)
+ */
+const INTERNED_FIELDS = new Set([
+  'file', 'name', 'qualifiedName', 'callee', 'usr', 'text', 'type', 'canonicalType', 'returnType'
+]);
+
+/**
+ * String table of one exporter output stream
+ */
+export class InternedStringTable {
+  private strings: string[] = [];
+
+  /**
+   * Append the strings a record adds to the table, then replace the indices
+   * in its interned fields by their strings (in place).
+   *
+   * @param record - Next record of the stream
+   * @returns The resolved record
+   * @throws Error if an index is outside the table
+   */
+  resolveRecord(record: any): any {
+    if (record && Array.isArray(record.strings)) {
+      // Not push(...strings): a whole document's table can exceed the argument limit
+      for (const string of record.strings) {
+        this.strings.push(string);
+      }
+      delete record.strings;
+    }
+    this.resolveFields(record);
+    return record;
+  }
+
+  private resolveFields(value: any): void {
+    if (Array.isArray(value)) {
+      value.forEach(element => this.resolveFields(element));
+      return;
+    }
+    if (!value || typeof value !== 'object') {
+      return;
+    }
+    for (const key of Object.keys(value)) {
+      const field = value[key];
+      if (typeof field === 'number' && INTERNED_FIELDS.has(key)) {
+        if (field < 0 || field >= this.strings.length) {
+          throw new Error(`Interned string ${field} is not in the table (${this.strings.length} strings)`);
+        }
+        value[key] = this.strings[field];
+      } else if (field && typeof field === 'object') {
+        this.resolveFields(field);
+      }
+    }
+  }
+}
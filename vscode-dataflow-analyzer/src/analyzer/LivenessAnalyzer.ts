@@ -22,10 +22,12 @@
  * PROCESSING:
  *   1. Computes USE[B] and DEF[B] sets for each block B
  *   2. Initializes all IN/OUT sets to empty
- *   3. Iteratively recomputes IN/OUT sets in reverse CFG order:
+ *   3. Iteratively recomputes IN/OUT sets in postorder (exported by
+ *      cfg-exporter; reverse CFG order without it):
  *      - OUT[B] = union of IN[S] for all successors S of B
  *      - IN[B] = USE[B] union (OUT[B] - DEF[B])
- *   4. Continues until reaching fixed point (no changes)
+ *   4. Revisits a block only when a successor's IN set changed, until
+ *      reaching fixed point (no changes)
  * 
  * OUTPUTS:
  *   - Map<string, LivenessInfo> where:
@@ -96,26 +98,24 @@ export class LivenessAnalyzer {
     });
     console.log(`[LivenessAnalyzer] [DEBUG] Initialized ${livenessMap.size} blocks with empty IN/OUT sets`);
 
-    // STEP 2: Iterative dataflow analysis until reaching fixed point
-    // Fixed point: when IN and OUT sets don't change from one iteration to the next
+    // STEP 2: Worklist iteration until reaching fixed point
+    // Blocks are visited in postorder (successors before predecessors, back
+    // edges aside), so one pass propagates liveness through acyclic code and
+    // each enclosing loop adds about one more pass. A block is revisited only
+    // when the IN set of one of its successors changed.
     // CRITICAL FIX (LOGIC.md #1): Add MAX_ITERATIONS safety check for algorithm termination
-    // CRITICAL FIX (LOGIC.md #10): Compute all new values first, then update atomically
+    const blockIds = this.getBackwardOrder(functionCFG);
+    const pending = new Set<string>(blockIds);
     const MAX_ITERATIONS = 10 * functionCFG.blocks.size;
-    let changed = true;
     let iteration = 0;
-    while (changed && iteration < MAX_ITERATIONS) {
-      changed = false;
+    while (pending.size > 0 && iteration < MAX_ITERATIONS) {
       iteration++;
       
-      // STEP 3: Process blocks in REVERSE order (backward analysis)
-      // Backward analysis is required for liveness (we compute from uses to definitions)
-      const blockIds = Array.from(functionCFG.blocks.keys()).reverse();
-      
-      // CRITICAL FIX (LOGIC.md #10): Compute all new values first, then update atomically
-      // This prevents order-dependent incorrect results
-      const newValues = new Map<string, { newIn: Set<string>; newOut: Set<string> }>();
-      
       for (const blockId of blockIds) {
+        if (!pending.delete(blockId)) {
+          continue;
+        }
+        
         // CRITICAL FIX (LOGIC.md #3): Add null checks before accessing blocks
         const block = functionCFG.blocks.get(blockId);
         const liveness = livenessMap.get(blockId);
@@ -125,7 +125,7 @@ export class LivenessAnalyzer {
           continue;
         }
         
-        // STEP 4a: Compute OUT[B] = union of IN[S] for all successors S
+        // STEP 3a: Compute OUT[B] = union of IN[S] for all successors S
         // Variables live at block exit = union of variables live at successor entries
         const newOut = new Set<string>();
         for (const succId of block.successors) {
@@ -136,7 +136,7 @@ export class LivenessAnalyzer {
           }
         }
         
-        // STEP 4b: Compute IN[B] = USE[B] union (OUT[B] - DEF[B])
+        // STEP 3b: Compute IN[B] = USE[B] union (OUT[B] - DEF[B])
         // Variables live at block entry = variables used in block + (variables live at exit that aren't defined in block)
         const use = this.getUseSet(block);    // Variables read in this block
         const def = this.getDefSet(block);    // Variables written in this block
@@ -149,32 +149,23 @@ export class LivenessAnalyzer {
           }
         });
         
-        // Store new values for atomic update
-        newValues.set(blockId, { newIn, newOut });
-      }
-      
-      // CRITICAL FIX (LOGIC.md #10): Update all values atomically after computing all new values
-      newValues.forEach((values, blockId) => {
-        const liveness = livenessMap.get(blockId);
-        if (!liveness) return;
+        liveness.out = newOut;
         
-        // Check if OUT[B] changed
-        if (!this.setsEqual(liveness.out, values.newOut)) {
-          changed = true;
-          liveness.out = values.newOut;
+        // STEP 3c: A changed IN[B] changes the OUT set of every predecessor
+        if (!this.setsEqual(liveness.in, newIn)) {
+          liveness.in = newIn;
+          block.predecessors.forEach(predId => {
+            if (livenessMap.has(predId)) {
+              pending.add(predId);
+            }
+          });
         }
-        
-        // Check if IN[B] changed
-        if (!this.setsEqual(liveness.in, values.newIn)) {
-          changed = true;
-          liveness.in = values.newIn;
-        }
-      });
+      }
     }
     
     // CRITICAL FIX (LOGIC.md #1): Warn if convergence not reached
     const analysisTimeMs = Date.now() - analysisStartTime;
-    if (iteration >= MAX_ITERATIONS) {
+    if (pending.size > 0) {
       console.warn(`[LivenessAnalyzer] [WARN] Reached MAX_ITERATIONS (${MAX_ITERATIONS}) without convergence for function ${functionCFG.name}!`);
       console.warn(`[LivenessAnalyzer] [WARN] This may indicate a bug in the CFG structure or analysis algorithm.`);
     } else {
@@ -185,6 +176,20 @@ export class LivenessAnalyzer {
     return livenessMap;
   }
 
+  /**
+   * Block visiting order for the backward analysis: the postorder exported by
+   * cfg-exporter (unreachable blocks last), or reverse CFG order without it.
+   */
+  private getBackwardOrder(functionCFG: FunctionCFG): string[] {
+    const blockIds = Array.from(functionCFG.blocks.keys());
+    const hasOrder = blockIds.some(blockId => functionCFG.blocks.get(blockId)!.postorder !== undefined);
+    if (!hasOrder) {
+      return blockIds.reverse();
+    }
+    const position = (blockId: string) => functionCFG.blocks.get(blockId)!.postorder ?? Number.MAX_SAFE_INTEGER;
+    return blockIds.sort((a, b) => position(a) - position(b));
+  }
+
   /**
    * Extract USE[B] - set of variables read (used) in this block.
    * 
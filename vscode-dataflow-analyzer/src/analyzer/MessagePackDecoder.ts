@@ -0,0 +1,299 @@
+/**
+ * MessagePackDecoder.ts
+ *
+ * Streaming MessagePack decoder for cfg-exporter binary output
+ *
+ * PURPOSE:
+ * cfg-exporter can write its output as MessagePack (--format=msgpack), which is
+ * several times smaller than JSON text and avoids building and re-parsing large
+ * strings. This module decodes that output without any runtime dependency.
+ *
+ * SIGNIFICANCE IN OVERALL FLOW:
+ * Used by ClangASTParser.ts and CFGExporterClient.ts to turn exporter stdout back
+ * into the same plain objects JSON.parse would have produced.
+ *
+ * DATA FLOW:
+ * INPUTS:
+ *   - Raw stdout chunks of cfg-exporter (arbitrary chunk boundaries)
+ *
+ * PROCESSING:
+ *   1. Appends chunks to an internal buffer
+ *   2. Decodes every complete top-level value (values are self-delimiting)
+ *   3. Keeps the incomplete tail until more data arrives
+ *
+ * OUTPUTS:
+ *   - Decoded values (objects, arrays, strings, numbers, booleans, null)
+ *
+ * LIMITATIONS:
+ *   - Extension types are returned as { type, data } and are not interpreted
+ *   - 64-bit integers outside the safe integer range lose precision
+ */
+
+/**
+ * Thrown internally when the buffer ends inside a value
+ */
+class IncompleteValueError extends Error {}
+
+class MessagePackReader {
+  offset = 0;
+
+  constructor(private data: Buffer) {}
+
+  read(): any {
+    const type = this.byte();
+
+    if (type <= 0x7f) return type;                                   // positive fixint
+    if (type >= 0xe0) return type - 0x100;                           // negative fixint
+    if (type >= 0x80 && type <= 0x8f) return this.map(type & 0x0f);  // fixmap
+    if (type >= 0x90 && type <= 0x9f) return this.array(type & 0x0f); // fixarray
+    if (type >= 0xa0 && type <= 0xbf) return this.str(type & 0x1f);  // fixstr
+
+    switch (type) {
+      case 0xc0: return null;
+      case 0xc2: return false;
+      case 0xc3: return true;
+      case 0xc4: return this.bin(this.uint(1));
+      case 0xc5: return this.bin(this.uint(2));
+      case 0xc6: return this.bin(this.uint(4));
+      case 0xc7: return this.ext(this.uint(1));
+      case 0xc8: return this.ext(this.uint(2));
+      case 0xc9: return this.ext(this.uint(4));
+      case 0xca: return this.number(4, (o) => this.data.readFloatBE(o));
+      case 0xcb: return this.number(8, (o) => this.data.readDoubleBE(o));
+      case 0xcc: return this.uint(1);
+      case 0xcd: return this.uint(2);
+      case 0xce: return this.uint(4);
+      case 0xcf: return this.number(8, (o) => Number(this.data.readBigUInt64BE(o)));
+      case 0xd0: return this.number(1, (o) => this.data.readInt8(o));
+      case 0xd1: return this.number(2, (o) => this.data.readInt16BE(o));
+      case 0xd2: return this.number(4, (o) => this.data.readInt32BE(o));
+      case 0xd3: return this.number(8, (o) => Number(this.data.readBigInt64BE(o)));
+      case 0xd4: return this.ext(1);
+      case 0xd5: return this.ext(2);
+      case 0xd6: return this.ext(4);
+      case 0xd7: return this.ext(8);
+      case 0xd8: return this.ext(16);
+      case 0xd9: return this.str(this.uint(1));
+      case 0xda: return this.str(this.uint(2));
+      case 0xdb: return this.str(this.uint(4));
+      case 0xdc: return this.array(this.uint(2));
+      case 0xdd: return this.array(this.uint(4));
+      case 0xde: return this.map(this.uint(2));
+      case 0xdf: return this.map(this.uint(4));
+      default:
+        throw new Error(`Invalid MessagePack type byte 0x${type.toString(16)} at offset ${this.offset - 1}`);
+    }
+  }
+
+  private need(length: number): void {
+    if (this.offset + length > this.data.length) {
+      throw new IncompleteValueError();
+    }
+  }
+
+  private byte(): number {
+    this.need(1);
+    return this.data[this.offset++];
+  }
+
+  private uint(length: number): number {
+    this.need(length);
+    const value = this.data.readUIntBE(this.offset, length);
+    this.offset += length;
+    return value;
+  }
+
+  private number(length: number, read: (offset: number) => number): number {
+    this.need(length);
+    const value = read(this.offset);
+    this.offset += length;
+    return value;
+  }
+
+  private str(length: number): string {
+    this.need(length);
+    const value = this.data.toString('utf8', this.offset, this.offset + length);
+    this.offset += length;
+    return value;
+  }
+
+  private bin(length: number): Buffer {
+    this.need(length);
+    const value = Buffer.from(this.data.subarray(this.offset, this.offset + length));
+    this.offset += length;
+    return value;
+  }
+
+  private ext(length: number): { type: number; data: Buffer } {
+    const type = this.number(1, (o) => this.data.readInt8(o));
+    return { type, data: this.bin(length) };
+  }
+
+  private array(length: number): any[] {
+    const value = new Array(length);
+    for (let i = 0; i < length; i++) {
+      value[i] = this.read();
+    }
+    return value;
+  }
+
+  private map(length: number): { [key: string]: any } {
+    const value: { [key: string]: any } = {};
+    for (let i = 0; i < length; i++) {
+      const key = this.read();
+      value[String(key)] = this.read();
+    }
+    return value;
+  }
+}
+
+/**
+ * Decode a buffer holding exactly one MessagePack value
+ *
+ * @throws Error if the buffer is truncated or malformed
+ */
+export function decodeMessagePack(data: Buffer): any {
+  const reader = new MessagePackReader(data);
+  try {
+    return reader.read();
+  } catch (error) {
+    if (error instanceof IncompleteValueError) {
+      throw new Error('Truncated MessagePack value');
+    }
+    throw error;
+  }
+}
+
+/**
+ * Size of the value header starting with a type byte: header bytes, payload
+ * bytes that follow it, and the number of nested values after the payload
+ * (array elements, map keys and values). Sized types read their length from
+ * the bytes after the type byte; null if those have not arrived yet.
+ */
+function valueHeader(data: Buffer, offset: number, end: number): [number, number, number] | null {
+  const type = data[offset];
+  const sized = (lengthBytes: number, extra: number, nested: number): [number, number, number] | null => {
+    if (offset + 1 + lengthBytes > end) {
+      return null;
+    }
+    const length = data.readUIntBE(offset + 1, lengthBytes);
+    return [1 + lengthBytes, nested ? 0 : length + extra, nested * length];
+  };
+
+  if (type <= 0x7f || type >= 0xe0) return [1, 0, 0];              // fixint
+  if (type >= 0x80 && type <= 0x8f) return [1, 0, 2 * (type & 0x0f)]; // fixmap
+  if (type >= 0x90 && type <= 0x9f) return [1, 0, type & 0x0f];     // fixarray
+  if (type >= 0xa0 && type <= 0xbf) return [1, type & 0x1f, 0];    // fixstr
+
+  switch (type) {
+    case 0xc0: case 0xc2: case 0xc3: return [1, 0, 0];
+    case 0xc4: return sized(1, 0, 0);
+    case 0xc5: return sized(2, 0, 0);
+    case 0xc6: return sized(4, 0, 0);
+    case 0xc7: return sized(1, 1, 0);                               // ext: length, then type byte
+    case 0xc8: return sized(2, 1, 0);
+    case 0xc9: return sized(4, 1, 0);
+    case 0xca: return [1, 4, 0];
+    case 0xcb: return [1, 8, 0];
+    case 0xcc: case 0xd0: return [1, 1, 0];
+    case 0xcd: case 0xd1: return [1, 2, 0];
+    case 0xce: case 0xd2: return [1, 4, 0];
+    case 0xcf: case 0xd3: return [1, 8, 0];
+    case 0xd4: return [1, 2, 0];                                    // fixext: type byte + data
+    case 0xd5: return [1, 3, 0];
+    case 0xd6: return [1, 5, 0];
+    case 0xd7: return [1, 9, 0];
+    case 0xd8: return [1, 17, 0];
+    case 0xd9: return sized(1, 0, 0);
+    case 0xda: return sized(2, 0, 0);
+    case 0xdb: return sized(4, 0, 0);
+    case 0xdc: return sized(2, 0, 1);
+    case 0xdd: return sized(4, 0, 1);
+    case 0xde: return sized(2, 0, 2);
+    case 0xdf: return sized(4, 0, 2);
+    default:
+      throw new Error(`Invalid MessagePack type byte 0x${type.toString(16)} at offset ${offset}`);
+  }
+}
+
+/**
+ * Incremental decoder for a stream of concatenated MessagePack values
+ * (cfg-exporter --format=msgpack --stream, or --batch output).
+ *
+ * A large value arrives in many pipe chunks. Chunks are appended to a buffer
+ * that grows geometrically, and the bounds of the pending value are found by
+ * scanning value headers only, resuming where the previous chunk stopped.
+ * Each value is decoded once, when its last byte has arrived, so the cost
+ * stays linear in the stream length however the stream is chunked.
+ */
+export class MessagePackStreamDecoder {
+  private buffer: Buffer = Buffer.alloc(0);
+  // Bytes of buffer in use; everything before them belongs to the pending value
+  private length = 0;
+  // Offset of the next header of the pending value still to be scanned
+  private scanned = 0;
+  // Values (the pending value and its nested values) not yet scanned
+  private valuesLeft = 1;
+
+  /**
+   * Append a chunk and return every value it completes, in stream order.
+   *
+   * @throws Error if the stream contains malformed data
+   */
+  push(chunk: Buffer): any[] {
+    this.append(chunk);
+
+    const values: any[] = [];
+    let start = 0;
+    while (this.scan()) {
+      values.push(decodeMessagePack(this.buffer.subarray(start, this.scanned)));
+      start = this.scanned;
+      this.valuesLeft = 1;
+    }
+
+    // Keep only the bytes of the next, incomplete value
+    if (start > 0) {
+      this.buffer.copy(this.buffer, 0, start, this.length);
+      this.length -= start;
+      this.scanned -= start;
+    }
+    return values;
+  }
+
+  /**
+   * Number of buffered bytes that do not yet form a complete value
+   */
+  get pendingBytes(): number {
+    return this.length;
+  }
+
+  private append(chunk: Buffer): void {
+    if (this.length + chunk.length > this.buffer.length) {
+      const grown = Buffer.allocUnsafe(Math.max(this.length + chunk.length, 2 * this.buffer.length, 64 * 1024));
+      this.buffer.copy(grown, 0, 0, this.length);
+      this.buffer = grown;
+    }
+    chunk.copy(this.buffer, this.length);
+    this.length += chunk.length;
+  }
+
+  /**
+   * Advance over the headers of the pending value that have arrived.
+   *
+   * @returns true if the value is complete (it ends at `scanned`)
+   */
+  private scan(): boolean {
+    while (this.valuesLeft > 0) {
+      if (this.scanned >= this.length) {
+        return false;
+      }
+      const header = valueHeader(this.buffer, this.scanned, this.length);
+      if (!header || this.scanned + header[0] + header[1] > this.length) {
+        return false;
+      }
+      this.scanned += header[0] + header[1];
+      this.valuesLeft += header[2] - 1;
+    }
+    return true;
+  }
+}
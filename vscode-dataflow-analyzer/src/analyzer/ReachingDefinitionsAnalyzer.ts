@@ -25,7 +25,9 @@
  *      - GEN[B] = definitions generated (assigned) in B
  *      - KILL[B] = all definitions of variables that are redefined in B (from ALL blocks)
  *   3. Initializes IN/OUT sets
- *   4. Iteratively computes IN/OUT sets in forward CFG order:
+ *   4. Iteratively computes IN/OUT sets in reverse postorder (exported by
+ *      cfg-exporter; CFG order without it), revisiting a block only when a
+ *      predecessor's OUT set changed:
  *      - IN[B] = union of OUT[P] for all predecessors P of B
  *      - OUT[B] = GEN[B] union (IN[B] - KILL[B])
  *   5. Tracks propagation paths for each definition
@@ -110,20 +112,22 @@ export class ReachingDefinitionsAnalyzer {
       console.log(`[ReachingDefinitionsAnalyzer] [DEBUG] Block ${blockId}: GEN=${Array.from(gen.keys()).length} vars, KILL=${Array.from(kill.keys()).length} vars`);
     });
 
-    // Step 3: Iterative dataflow analysis until reaching fixed point
+    // Step 3: Worklist iteration until reaching fixed point
+    // Blocks are visited in reverse postorder (predecessors before successors,
+    // back edges aside) and revisited only when a predecessor's OUT changed
     // MODERATE FIX (Issue #6): Add MAX_ITERATIONS safety check
+    const blockIds = this.getForwardOrder(functionCFG);
+    const pending = new Set<string>(blockIds);
     const MAX_ITERATIONS = 10 * functionCFG.blocks.size;
     let iteration = 0;
-    let changed = true;
-    while (changed && iteration < MAX_ITERATIONS) {
+    while (pending.size > 0 && iteration < MAX_ITERATIONS) {
       iteration++;
-      changed = false;
       console.log(`[ReachingDefinitionsAnalyzer] [DEBUG] Fixed-point iteration ${iteration}/${MAX_ITERATIONS}`);
       
-      // Process blocks in forward order (follows CFG edges)
-      const blockIds = Array.from(functionCFG.blocks.keys());
-      
       for (const blockId of blockIds) {
+        if (!pending.delete(blockId)) {
+          continue;
+        }
         const block = functionCFG.blocks.get(blockId)!;
         const rdInfo = rdMap.get(blockId)!;
         
@@ -238,7 +242,11 @@ export class ReachingDefinitionsAnalyzer {
         const outChanged = !this.mapsEqual(rdInfo.out, newOut);
         
         if (inChanged || outChanged) {
-          changed = true;
+          block.successors.forEach(succId => {
+            if (rdMap.has(String(succId))) {
+              pending.add(String(succId));
+            }
+          });
           console.log(`[ReachingDefinitionsAnalyzer] [DEBUG] Block ${blockId} changed - updating IN/OUT (iteration ${iteration})`);
           rdInfo.in = newIn;
           rdInfo.out = newOut;
@@ -252,7 +260,7 @@ export class ReachingDefinitionsAnalyzer {
     }
     
     const analysisTimeMs = Date.now() - analysisStartTime;
-    if (iteration >= MAX_ITERATIONS) {
+    if (pending.size > 0) {
       console.warn(`[ReachingDefinitionsAnalyzer] [WARN] Reached MAX_ITERATIONS (${MAX_ITERATIONS}) without convergence for function ${functionCFG.name}!`);
       console.warn(`[ReachingDefinitionsAnalyzer] [WARN] This may indicate a bug in the CFG structure or analysis algorithm.`);
     } else {
@@ -262,6 +270,20 @@ export class ReachingDefinitionsAnalyzer {
     return rdMap;
   }
 
+  /**
+   * Block visiting order for the forward analysis: the reverse postorder
+   * exported by cfg-exporter (unreachable blocks last), or CFG order without it
+   */
+  private getForwardOrder(functionCFG: FunctionCFG): string[] {
+    const blockIds = Array.from(functionCFG.blocks.keys());
+    const hasOrder = blockIds.some(blockId => functionCFG.blocks.get(blockId)!.rpo !== undefined);
+    if (!hasOrder) {
+      return blockIds;
+    }
+    const position = (blockId: string) => functionCFG.blocks.get(blockId)!.rpo ?? Number.MAX_SAFE_INTEGER;
+    return blockIds.sort((a, b) => position(a) - position(b));
+  }
+
   /**
    * Collect all definitions in the function across all blocks
    * A definition is where a variable receives a value
@@ -318,6 +318,13 @@ export class SanitizationRegistry {
     return this.sanitizers.get(functionName);
   }
 
+  /**
+   * Get all sanitization functions
+   */
+  getAllSanitizers(): SanitizationFunction[] {
+    return Array.from(this.sanitizers.values());
+  }
+
   /**
    * Add custom sanitization function
    */
@@ -91,9 +91,9 @@
  * - "Engineering a Compiler" (Cooper & Torczon) - Incremental Analysis
  */
 
-import { BasicBlock, FunctionCFG, TaintInfo, ReachingDefinitionsInfo, StatementType, TaintVulnerability, Statement, TaintLabel, TaintSensitivity } from '../types';
-import { TaintSourceRegistry, defaultTaintSourceRegistry } from './TaintSourceRegistry';
-import { TaintSinkRegistry, defaultTaintSinkRegistry } from './TaintSinkRegistry';
+import { BasicBlock, CallSite, CallSiteTaintTag, FunctionCFG, TaintInfo, ReachingDefinitionsInfo, StatementType, TaintVulnerability, Statement, TaintLabel, TaintSensitivity } from '../types';
+import { TaintSource, TaintSourceRegistry, defaultTaintSourceRegistry } from './TaintSourceRegistry';
+import { TaintSink, TaintSinkRegistry, defaultTaintSinkRegistry } from './TaintSinkRegistry';
 import { SanitizationRegistry, defaultSanitizationRegistry } from './SanitizationRegistry';
 import { FunctionCallExtractor } from './FunctionCallExtractor';
 
@@ -233,7 +233,11 @@ export class TaintAnalyzer {
         // Check if this is a taint source using enhanced registry
         if (stmt.type === StatementType.FUNCTION_CALL && stmt.text) {
           const stmtText = stmt.text || stmt.content || '';
-          const source = this.detectTaintSource(stmtText, blockId, stmt.id);
+          const definedVars = stmt.variableIds ? stmt.variables?.defined : undefined;
+          const tags = this.getTaintTags(functionCFG, block, stmt);
+          const source = tags
+            ? this.detectTaintSourceFromTags(tags, blockId, stmt.id)
+            : this.detectTaintSource(stmtText, blockId, stmt.id, definedVars);
           
           if (source) {
             const { variable, taintInfo } = source;
@@ -314,7 +318,10 @@ export class TaintAnalyzer {
           // Check for sanitization functions first
           if (stmt.type === StatementType.FUNCTION_CALL && stmt.text) {
             const stmtText = stmt.text || stmt.content || '';
-            const sanitizedVar = this.detectSanitization(stmtText, varName, taintMap);
+            const tags = this.getTaintTags(functionCFG, block, stmt);
+            const sanitizedVar = tags
+              ? this.detectSanitizationFromTags(tags, varName)
+              : this.detectSanitization(stmtText, varName, taintMap);
             
             if (sanitizedVar && sanitizedVar.removesTaint) {
               // Taint is removed - mark variable as sanitized
@@ -413,14 +420,17 @@ export class TaintAnalyzer {
       block.statements.forEach(stmt => {
         if (stmt.type === StatementType.FUNCTION_CALL && stmt.text) {
           const stmtText = stmt.text || stmt.content || '';
-          const sinkVulns = this.detectSinkVulnerabilities(
-            stmtText,
-            blockId,
-            stmt.id || '',
-            functionCFG.name,
-            taintMap,
-            functionCFG
-          );
+          const tags = this.getTaintTags(functionCFG, block, stmt);
+          const sinkVulns = tags
+            ? this.detectSinkVulnerabilitiesFromTags(tags, stmtText, blockId, stmt.id || '', functionCFG.name, taintMap)
+            : this.detectSinkVulnerabilities(
+                stmtText,
+                blockId,
+                stmt.id || '',
+                functionCFG.name,
+                taintMap,
+                functionCFG
+              );
           vulnerabilities.push(...sinkVulns);
         }
       });
@@ -523,40 +533,10 @@ export class TaintAnalyzer {
         for (const taintInfo of usedTaintInfos) {
           if (!taintInfo.tainted) continue;
           
-          const vulnType = this.mapSinkCategoryToVulnType(sinkDef.category);
-          const vulnerability: TaintVulnerability = {
-            id: `${functionName}_${blockId}_${statementId}_${usedVar}_${vulnType}`,
-            type: vulnType,
-            severity: sinkDef.severity,
-            source: {
-              file: '',
-              line: taintInfo.sourceLocation?.range?.start.line || 0,
-              function: functionName,
-              statement: '',
-              variable: taintInfo.variable
-            },
-            sink: {
-              file: '',
-              line: 0,
-              function: functionName,
-              statement: stmtText,
-              argumentIndex: -1 // Unknown, but variable is used
-            },
-            propagationPath: taintInfo.propagationPath.map(pathStr => {
-              const [bid, sid] = pathStr.split(':');
-              return {
-                file: '',
-                function: functionName,
-                blockId: bid,
-                statementId: sid || ''
-              };
-            }),
-            sanitized: taintInfo.sanitized || false,
-            sanitizationPoints: taintInfo.sanitizationPoints || [],
-            cweId: sinkDef.cweId,
-            description: sinkDef.description || `Tainted data from ${taintInfo.source} reaches ${sinkDef.functionName}`
-          };
-          vulnerabilities.push(vulnerability);
+          // Argument index unknown, but variable is used
+          vulnerabilities.push(this.createSinkVulnerability(
+            taintInfo, sinkDef, usedVar, -1, stmtText, blockId, statementId, functionName
+          ));
         }
       }
     }
@@ -584,49 +564,107 @@ export class TaintAnalyzer {
       for (const taintInfo of taintInfos) {
         if (!taintInfo.tainted) continue;
         
-        // Map sink category to vulnerability type
-        const vulnType = this.mapSinkCategoryToVulnType(sinkDef.category);
-        
-        const vulnerability: TaintVulnerability = {
-          id: `${functionName}_${blockId}_${statementId}_${varName}_${vulnType}`,
-          type: vulnType,
-          severity: sinkDef.severity,
-          source: {
-            file: '', // Will be filled by caller if available
-            line: taintInfo.sourceLocation?.range?.start.line || 0,
-            function: functionName,
-            statement: '', // Will be filled from source location
-            variable: taintInfo.variable
-          },
-          sink: {
-            file: '', // Will be filled by caller if available
-            line: 0, // Will be filled from statement range if available
-            function: functionName,
-            statement: stmtText,
-            argumentIndex: argIndex
-          },
-          propagationPath: taintInfo.propagationPath.map(pathStr => {
-            const [bid, sid] = pathStr.split(':');
-            return {
-              file: '',
-              function: functionName,
-              blockId: bid,
-              statementId: sid || ''
-            };
-          }),
-          sanitized: taintInfo.sanitized || false,
-          sanitizationPoints: taintInfo.sanitizationPoints || [],
-          cweId: sinkDef.cweId,
-          description: sinkDef.description || `Tainted data from ${taintInfo.source} reaches ${sinkDef.functionName}`
-        };
-        
-        vulnerabilities.push(vulnerability);
+        vulnerabilities.push(this.createSinkVulnerability(
+          taintInfo, sinkDef, varName, argIndex, stmtText, blockId, statementId, functionName
+        ));
       }
     }
     
     return vulnerabilities;
   }
 
+  /**
+   * Detect sink vulnerabilities from the exporter's call-site taint tags: the
+   * variables read by each sink's tainted arguments are checked directly
+   */
+  private detectSinkVulnerabilitiesFromTags(
+    tags: Array<{ site: CallSite; tag: CallSiteTaintTag }>,
+    stmtText: string,
+    blockId: string,
+    statementId: string,
+    functionName: string,
+    taintMap: Map<string, TaintInfo[]>
+  ): TaintVulnerability[] {
+    const vulnerabilities: TaintVulnerability[] = [];
+
+    // Calls that create taint here are not sinks for it (see detectSinkVulnerabilities)
+    if (tags.some(({ tag }) => tag.role === 'source' && tag.target)) {
+      return vulnerabilities;
+    }
+
+    for (const { site, tag } of tags) {
+      if (tag.role !== 'sink') continue;
+      const sinkDef = this.sinkRegistry.getTaintSink(tag.entry);
+      if (!sinkDef) continue;
+
+      const reported = new Set<string>();
+      for (const argIndex of tag.arguments) {
+        for (const varName of site.arguments[argIndex]?.used || []) {
+          if (reported.has(varName)) continue;
+          reported.add(varName);
+          for (const taintInfo of taintMap.get(varName) || []) {
+            if (!taintInfo.tainted) continue;
+            vulnerabilities.push(this.createSinkVulnerability(
+              taintInfo, sinkDef, varName, argIndex, stmtText, blockId, statementId, functionName
+            ));
+          }
+        }
+      }
+    }
+
+    return vulnerabilities;
+  }
+
+  /**
+   * Vulnerability report for tainted data (taintInfo, held by varName)
+   * reaching argument argIndex (-1: unknown) of a sink call
+   */
+  private createSinkVulnerability(
+    taintInfo: TaintInfo,
+    sinkDef: TaintSink,
+    varName: string,
+    argIndex: number,
+    stmtText: string,
+    blockId: string,
+    statementId: string,
+    functionName: string
+  ): TaintVulnerability {
+    // Map sink category to vulnerability type
+    const vulnType = this.mapSinkCategoryToVulnType(sinkDef.category);
+    return {
+      id: `${functionName}_${blockId}_${statementId}_${varName}_${vulnType}`,
+      type: vulnType,
+      severity: sinkDef.severity,
+      source: {
+        file: '', // Will be filled by caller if available
+        line: taintInfo.sourceLocation?.range?.start.line || 0,
+        function: functionName,
+        statement: '', // Will be filled from source location
+        variable: taintInfo.variable
+      },
+      sink: {
+        file: '', // Will be filled by caller if available
+        line: 0, // Will be filled from statement range if available
+        function: functionName,
+        statement: stmtText,
+        argumentIndex: argIndex
+      },
+      propagationPath: taintInfo.propagationPath.map(pathStr => {
+        const [bid, sid] = pathStr.split(':');
+        return {
+          file: '',
+          function: functionName,
+          blockId: bid,
+          statementId: sid || ''
+        };
+      }),
+      sanitized: taintInfo.sanitized || false,
+      sanitizationPoints: taintInfo.sanitizationPoints || [],
+      cweId: sinkDef.cweId,
+      description: sinkDef.description || `Tainted data from ${taintInfo.source} reaches ${sinkDef.functionName}`
+    };
+  }
+
   /**
    * Map sink category to vulnerability type
    */
@@ -697,6 +735,31 @@ export class TaintAnalyzer {
     return null;
   }
 
+  /**
+   * Detect sanitization from the exporter's call-site taint tags: the tainted
+   * variable is sanitized if a sanitizer reads it as its input or writes it
+   */
+  private detectSanitizationFromTags(
+    tags: Array<{ site: CallSite; tag: CallSiteTaintTag }>,
+    taintedVarName: string
+  ): { variable: string; type: string; removesTaint: boolean } | null {
+    for (const { site, tag } of tags) {
+      if (tag.role !== 'sanitizer') continue;
+      const sanitizer = this.sanitizationRegistry.getSanitizationFunction(tag.entry);
+      if (!sanitizer) continue;
+
+      const readsTainted = tag.arguments.some(index => site.arguments[index]?.used.includes(taintedVarName));
+      if (readsTainted || tag.target === taintedVarName) {
+        return {
+          variable: tag.target || taintedVarName,
+          type: sanitizer.type,
+          removesTaint: sanitizer.removesTaint
+        };
+      }
+    }
+    return null;
+  }
+
   /**
    * Detect taint source from function call statement
    * Uses CFG-aware function extraction instead of regex
@@ -704,7 +767,8 @@ export class TaintAnalyzer {
   private detectTaintSource(
     stmtText: string,
     blockId: string,
-    statementId?: string
+    statementId?: string,
+    astDefinedVars?: string[]
   ): { variable: string; taintInfo: TaintInfo } | null {
     // Extract function call using CFG-aware extractor
     const tempStmt: Statement = { text: stmtText };
@@ -728,9 +792,9 @@ export class TaintAnalyzer {
     // If we can't extract target variable, try using variables from statement
     let variable = targetVar;
     if (!variable) {
-      // Fallback: use variables defined in statement
-      // This is a heuristic - in practice, we'd parse the statement more carefully
-      const definedVars = this.extractDefinedVariables(stmtText);
+      // Fallback: use variables defined in statement, from the AST when the
+      // exporter provided DEF sets, otherwise from the statement text
+      const definedVars = astDefinedVars ?? this.extractDefinedVariables(stmtText);
       if (definedVars.length > 0) {
         variable = definedVars[0];
       } else {
@@ -744,6 +808,40 @@ export class TaintAnalyzer {
 
     if (!variable) return null;
 
+    return { variable, taintInfo: this.createSourceTaintInfo(sourceDef, funcName, variable, blockId, statementId) };
+  }
+
+  /**
+   * Detect a taint source from the exporter's call-site taint tags; the
+   * tagged target is the variable receiving the taint
+   */
+  private detectTaintSourceFromTags(
+    tags: Array<{ site: CallSite; tag: CallSiteTaintTag }>,
+    blockId: string,
+    statementId?: string
+  ): { variable: string; taintInfo: TaintInfo } | null {
+    for (const { tag } of tags) {
+      if (tag.role !== 'source' || !tag.target) continue;
+      const sourceDef = this.sourceRegistry.getTaintSource(tag.entry);
+      if (!sourceDef) continue;
+      return {
+        variable: tag.target,
+        taintInfo: this.createSourceTaintInfo(sourceDef, tag.entry, tag.target, blockId, statementId)
+      };
+    }
+    return null;
+  }
+
+  /**
+   * Taint info for variable, tainted by a call of source funcName
+   */
+  private createSourceTaintInfo(
+    sourceDef: TaintSource,
+    funcName: string,
+    variable: string,
+    blockId: string,
+    statementId?: string
+  ): TaintInfo {
     // Create taint info with enhanced metadata and labels
     // Format propagation path with function name and block label
     // Note: functionCFG is not available here, use currentFunctionCFG
@@ -771,7 +869,29 @@ export class TaintAnalyzer {
       labels: [this.mapCategoryToLabel(sourceDef.category)]
     };
 
-    return { variable, taintInfo };
+    return taintInfo;
+  }
+
+  /**
+   * Call-site taint tags of the calls in stmt (empty for untagged statements),
+   * or undefined if the function was exported without a registry spec (calls
+   * are then classified by text)
+   */
+  private getTaintTags(
+    functionCFG: FunctionCFG,
+    block: BasicBlock,
+    stmt: Statement
+  ): Array<{ site: CallSite; tag: CallSiteTaintTag }> | undefined {
+    if (!functionCFG.taintTagged) {
+      return undefined;
+    }
+    const tags: Array<{ site: CallSite; tag: CallSiteTaintTag }> = [];
+    for (const site of block.callSites || []) {
+      if (site.statementId === stmt.id) {
+        (site.taint || []).forEach(tag => tags.push({ site, tag }));
+      }
+    }
+    return tags;
   }
   
   /**
@@ -920,11 +1040,18 @@ export class TaintAnalyzer {
    * 2. For each conditional, find blocks that are control-dependent on it
    * 3. Use path-sensitive analysis if enabled (PRECISE/MAXIMUM)
    * 
+   * Path-sensitive analysis uses the control dependences exported by
+   * cfg-exporter when the blocks carry them.
+   * 
    * Reference: "Control Dependence" - Ferrante et al. (1987)
    */
   private buildControlDependencyGraph(functionCFG: FunctionCFG): Map<string, Set<string>> {
     console.log(`[TaintAnalyzer] [DEBUG] Building control dependency graph for ${functionCFG.name}`);
     
+    if (this.shouldEnablePathSensitive() && this.hasExportedControlDependencies(functionCFG)) {
+      return this.buildExportedControlDependencyGraph(functionCFG);
+    }
+    
     const controlDeps = new Map<string, Set<string>>();
     
     functionCFG.blocks.forEach((block, blockId) => {
@@ -945,10 +1072,71 @@ export class TaintAnalyzer {
     return controlDeps;
   }
 
+  /**
+   * Whether every block carries control dependences from cfg-exporter
+   */
+  private hasExportedControlDependencies(functionCFG: FunctionCFG): boolean {
+    for (const block of functionCFG.blocks.values()) {
+      if (!block.controlDependencies) {
+        return false;
+      }
+    }
+    return functionCFG.blocks.size > 0;
+  }
+
+  /**
+   * Control dependency graph from the control dependences Clang computed
+   * (ControlDependencyCalculator), without searching the CFG from each
+   * conditional.
+   * 
+   * Every block that branches on a condition is a conditional block. A block
+   * depends on a conditional transitively: the body of an inner `if` depends
+   * on the outer condition as well, like with the reachability-based search.
+   */
+  private buildExportedControlDependencyGraph(functionCFG: FunctionCFG): Map<string, Set<string>> {
+    // Invert "block -> blocks it depends on" to "conditional -> direct dependents"
+    const directDependents = new Map<string, string[]>();
+    functionCFG.blocks.forEach((block, blockId) => {
+      block.controlDependencies!.forEach(conditionalBlockId => {
+        const dependents = directDependents.get(conditionalBlockId) || [];
+        dependents.push(blockId);
+        directDependents.set(conditionalBlockId, dependents);
+      });
+    });
+    
+    const controlDeps = new Map<string, Set<string>>();
+    directDependents.forEach((_dependents, conditionalBlockId) => {
+      const conditionalBlock = functionCFG.blocks.get(conditionalBlockId);
+      if (!conditionalBlock || this.extractConditionalVariables(conditionalBlock).length === 0) {
+        return;
+      }
+      
+      const dependentBlocks = new Set<string>();
+      const stack = [...directDependents.get(conditionalBlockId)!];
+      while (stack.length > 0) {
+        const blockId = stack.pop()!;
+        if (dependentBlocks.has(blockId)) continue;
+        dependentBlocks.add(blockId);
+        stack.push(...(directDependents.get(blockId) || []));
+      }
+      controlDeps.set(conditionalBlockId, dependentBlocks);
+    });
+    
+    console.log(`[TaintAnalyzer] [ControlDependentTaint] Control dependency graph from exported control dependences: ${controlDeps.size} conditionals`);
+    return controlDeps;
+  }
+
   /**
    * Check if a block is a conditional statement
+   * 
+   * Blocks exported with their terminator branch exactly when it has a
+   * condition that is not a constant (`if (DEBUG)` always goes one way);
+   * others are recognized from the statement text.
    */
   private isConditionalBlock(block: BasicBlock): boolean {
+    if (block.terminator !== undefined) {
+      return !!block.terminator?.condition && block.terminator.condition.constant === undefined;
+    }
     return block.statements.some(stmt => {
       const stmtType = stmt.type;
       const stmtText = stmt.text || stmt.content || '';
@@ -966,6 +1154,11 @@ export class TaintAnalyzer {
    * Extract variables used in conditional statements
    */
   private extractConditionalVariables(block: BasicBlock): string[] {
+    // Exported terminators carry the variables the condition reads
+    if (block.terminator !== undefined) {
+      return block.terminator?.condition?.used || [];
+    }
+    
     const vars: string[] = [];
     
     block.statements.forEach(stmt => {
@@ -1055,8 +1248,12 @@ export class TaintAnalyzer {
     const allReachable = new Set<string>();
     const branchReachable = new Map<number, Set<string>>();
     
-    // Get all branches from conditional (successors represent different branches)
-    const branches = conditionalBlock.successors;
+    // Get all branches from conditional (successors represent different branches);
+    // an exported two-way branch names its feasible true/false edges
+    const terminator = conditionalBlock.terminator;
+    const branches = terminator && (terminator.trueSuccessor || terminator.falseSuccessor)
+      ? [terminator.trueSuccessor, terminator.falseSuccessor].filter((id): id is string => id !== undefined)
+      : conditionalBlock.successors;
     
     if (branches.length === 0) {
       return new Set();
@@ -1231,11 +1428,26 @@ export class TaintAnalyzer {
         }
       }
       
+      // Field-sensitive analysis: fields, elements and pointees written, by
+      // the access paths the exporter resolved
+      if (this.shouldEnableFieldSensitive() && stmt.accessPaths) {
+        stmt.accessPaths.defined.forEach(path => {
+          if (this.propagateFieldSensitiveTaint(path.base, path.key, taintMap, functionCFG, conditionalBlockId, blockId, context)) {
+            changed = true;
+          }
+        });
+      }
+      
       stmt.variables?.defined.forEach(varName => {
         // Field-sensitive analysis: track struct fields separately
         if (this.shouldEnableFieldSensitive() && this.isStructFieldAccess(varName)) {
-          this.propagateFieldSensitiveTaint(varName, taintMap, functionCFG, conditionalBlockId, blockId, context);
-          changed = true;
+          // Text-based statements name fields as struct.field / ptr->field
+          const fieldMatch = varName.match(/([a-zA-Z_][a-zA-Z0-9_]*)[\.->]([a-zA-Z_][a-zA-Z0-9_]*)/);
+          if (fieldMatch && this.propagateFieldSensitiveTaint(
+            fieldMatch[1], `${fieldMatch[1]}.${fieldMatch[2]}`, taintMap, functionCFG, conditionalBlockId, blockId, context
+          )) {
+            changed = true;
+          }
           return;
         }
         
@@ -1336,27 +1548,19 @@ export class TaintAnalyzer {
 
   /**
    * Propagate field-sensitive taint for struct fields
-   * Tracks taint at the field level (e.g., struct.foo vs struct.bar)
+   * Tracks taint at the field level (e.g., struct.foo vs struct.bar), keyed by
+   * the access path's canonical spelling. Returns true if a field was marked.
    */
   private propagateFieldSensitiveTaint(
-    varName: string,
+    structName: string,
+    fieldTaintKey: string,
     taintMap: Map<string, TaintInfo[]>,
     functionCFG: FunctionCFG,
     conditionalBlockId: string,
     blockId: string,
     context: string | null = null
-  ): void {
-    console.log(`[TaintAnalyzer] [FieldSensitive] Propagating field-sensitive taint for ${varName}`);
-    
-    // Extract struct name and field name
-    const fieldMatch = varName.match(/([a-zA-Z_][a-zA-Z0-9_]*)[\.->]([a-zA-Z_][a-zA-Z0-9_]*)/);
-    if (!fieldMatch) {
-      // Not a struct field access, treat as regular variable
-      return;
-    }
-    
-    const structName = fieldMatch[1];
-    const fieldName = fieldMatch[2];
+  ): boolean {
+    console.log(`[TaintAnalyzer] [FieldSensitive] Propagating field-sensitive taint for ${fieldTaintKey}`);
     
     // Check if the struct itself is tainted
     const structTaintInfos = taintMap.get(structName) || [];
@@ -1364,7 +1568,6 @@ export class TaintAnalyzer {
     
     if (structIsTainted) {
       // Create field-specific taint entry
-      const fieldTaintKey = `${structName}.${fieldName}`;
       const fieldTaintInfos = taintMap.get(fieldTaintKey) || [];
       
       const hasControlDependent = fieldTaintInfos.some(t => 
@@ -1397,8 +1600,10 @@ export class TaintAnalyzer {
         fieldTaintInfos.push(newTaintInfo);
         taintMap.set(fieldTaintKey, fieldTaintInfos);
         console.log(`[TaintAnalyzer] [FieldSensitive] Marked field ${fieldTaintKey} as control-dependent tainted`);
+        return true;
       }
     }
+    return false;
   }
 
   /**
@@ -0,0 +1,97 @@
+/**
+ * TaintRegistrySpec.ts
+ *
+ * Registry spec for cfg-exporter --taint-spec
+ *
+ * PURPOSE:
+ * Serializes the taint source, sink and sanitizer registries into the JSON spec
+ * cfg-exporter loads into its callee lookup table. Call sites then arrive tagged
+ * with their taint role, category, argument indices and target variable, so
+ * TaintAnalyzer classifies a call by reading a field instead of matching
+ * registry names against every statement's text.
+ *
+ * DATA FLOW:
+ * INPUTS:
+ *   - TaintSourceRegistry, TaintSinkRegistry, SanitizationRegistry entries
+ *
+ * OUTPUTS:
+ *   - Spec file in the OS temp directory, named by the hash of its contents
+ *     (the exporter server keeps loaded specs by path)
+ *
+ * LIMITATIONS:
+ *   - Entries with a regex `pattern` cannot be matched by exact callee name;
+ *     no spec is written for registries containing them, so text matching
+ *     stays in effect
+ */
+
+import * as crypto from 'crypto';
+import * as fs from 'fs';
+import * as os from 'os';
+import * as path from 'path';
+import { TaintSourceRegistry } from './TaintSourceRegistry';
+import { TaintSinkRegistry } from './TaintSinkRegistry';
+import { SanitizationRegistry } from './SanitizationRegistry';
+
+export interface TaintRegistrySpec {
+  sources: { name: string; category: string; argumentIndex: number }[];
+  sinks: { name: string; category: string; argumentIndices: number[] }[];
+  sanitizers: { name: string; type: string; inputIndex: number; outputIndex: number }[];
+}
+
+/**
+ * Spec of the given registries, or null if an entry needs regex matching
+ */
+export function buildTaintRegistrySpec(
+  sourceRegistry: TaintSourceRegistry,
+  sinkRegistry: TaintSinkRegistry,
+  sanitizationRegistry: SanitizationRegistry
+): TaintRegistrySpec | null {
+  const sources = sourceRegistry.getAllSources();
+  const sinks = sinkRegistry.getAllSinks();
+  const sanitizers = sanitizationRegistry.getAllSanitizers();
+  if ([...sources, ...sinks, ...sanitizers].some(entry => entry.pattern)) {
+    return null;
+  }
+
+  return {
+    sources: sources.map(source => ({
+      name: source.functionName,
+      category: source.category,
+      argumentIndex: source.argumentIndex
+    })),
+    sinks: sinks.map(sink => ({
+      name: sink.functionName,
+      category: sink.category,
+      argumentIndices: sink.argumentIndices
+    })),
+    sanitizers: sanitizers.map(sanitizer => ({
+      name: sanitizer.functionName,
+      type: sanitizer.type,
+      inputIndex: sanitizer.inputIndex,
+      outputIndex: sanitizer.outputIndex
+    }))
+  };
+}
+
+/**
+ * Write the registries' spec for cfg-exporter and return its path, or
+ * undefined if the registries cannot be expressed as a spec
+ */
+export function writeTaintRegistrySpec(
+  sourceRegistry: TaintSourceRegistry,
+  sinkRegistry: TaintSinkRegistry,
+  sanitizationRegistry: SanitizationRegistry
+): string | undefined {
+  const spec = buildTaintRegistrySpec(sourceRegistry, sinkRegistry, sanitizationRegistry);
+  if (!spec) {
+    return undefined;
+  }
+
+  const contents = JSON.stringify(spec);
+  const hash = crypto.createHash('sha256').update(contents).digest('hex').slice(0, 16);
+  const specPath = path.join(os.tmpdir(), `dataflow-taint-spec-${hash}.json`);
+  if (!fs.existsSync(specPath)) {
+    fs.writeFileSync(specPath, contents);
+  }
+  return specPath;
+}
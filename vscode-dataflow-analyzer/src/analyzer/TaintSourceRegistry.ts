@@ -42,6 +42,27 @@ export interface TaintSource {
   description?: string;
 }
 
+/**
+ * Taint type of data held in a variable of the given C++ type (canonical
+ * spelling from the exported signature), or undefined if it says nothing.
+ */
+export function taintTypeFromDeclaredType(type: string): TaintType | undefined {
+  const bare = type.replace(/\b(const|volatile)\b|&/g, '').replace(/\s+/g, ' ').trim();
+  if (/\b(unsigned char|signed char|uint8_t|std::byte|void) ?[*[]/.test(bare) || /\b(vector|array)</.test(bare)) {
+    return 'buffer';
+  }
+  if (/\bchar ?[*[]/.test(bare) || /\bbasic_string(_view)?</.test(bare)) {
+    return 'string';
+  }
+  if (/[*[]/.test(bare)) {
+    return 'pointer';
+  }
+  if (/^(unsigned |signed )?(char|short|int|long|long long|bool)( int)?$/.test(bare)) {
+    return 'integer';
+  }
+  return undefined;
+}
+
 /**
  * Registry of all known taint sources
  */
@@ -0,0 +1,51 @@
+/**
+ * Unit tests for CFGExporterClient
+ *
+ * These tests verify:
+ * 1. A response frame that cannot be decoded rejects the pending request
+ *    instead of leaving it unsettled
+ * 2. The client starts a new server for the next request
+ */
+
+import * as fs from 'fs';
+import * as os from 'os';
+import * as path from 'path';
+import { CFGExporterClient } from '../CFGExporterClient';
+
+/**
+ * Stand-in for `cfg-exporter --serve` that answers every request with a
+ * frame whose payload is not JSON
+ */
+function writeCorruptServer(dir: string): string {
+  const serverPath = path.join(dir, 'corrupt-server.sh');
+  fs.writeFileSync(serverPath, "#!/bin/sh\nprintf 'Content-Length: 5\\r\\n\\r\\n{id:1'\ncat > /dev/null\n");
+  fs.chmodSync(serverPath, 0o755);
+  return serverPath;
+}
+
+const posixTest = process.platform === 'win32' ? test.skip : test;
+
+describe('CFGExporterClient', () => {
+  let dir: string;
+  let client: CFGExporterClient;
+
+  beforeEach(() => {
+    dir = fs.mkdtempSync(path.join(os.tmpdir(), 'cfg-exporter-client-'));
+    client = new CFGExporterClient(writeCorruptServer(dir), []);
+  });
+
+  afterEach(() => {
+    client.dispose();
+    fs.rmSync(dir, { recursive: true, force: true });
+  });
+
+  posixTest('rejects the pending request on a malformed frame', async () => {
+    await expect(client.request('export', { file: 'a.cpp' })).rejects.toThrow(/Malformed cfg-exporter response frame/);
+    expect(client.isRunning()).toBe(false);
+  });
+
+  posixTest('restarts the server for the next request', async () => {
+    await expect(client.request('export', { file: 'a.cpp' })).rejects.toThrow(/Malformed/);
+    await expect(client.request('export', { file: 'b.cpp' })).rejects.toThrow(/Malformed/);
+  });
+});
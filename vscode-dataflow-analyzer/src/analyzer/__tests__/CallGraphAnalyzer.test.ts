@@ -272,6 +272,84 @@ describe('CallGraphAnalyzer - Phase 1: Foundation', () => {
       );
       expect(invalidCalls.length).toBe(0);
     });
+
+    it('should use resolved call sites instead of statement text', () => {
+      const functions = new Map<string, FunctionCFG>();
+      const caller = createMockCFG('caller', ['int n = parse(s, 10);']);
+      caller.blocks.get('B0')!.callSites = [{
+        statementId: '1.3',
+        callee: 'util::parse',
+        name: 'parse',
+        usr: 'c:@N@util@F@parse#&1$@N@std@S@basic_string#C#I#',
+        arguments: [
+          { text: 's', type: 'std::string', defined: [], used: ['s'] },
+          { text: '10', type: 'int', defined: [], used: [] }
+        ],
+        returnUsed: true,
+        assignedTo: 'n'
+      }];
+      functions.set('caller', caller);
+      functions.set('parse', createMockCFG('parse', ['return 0;']));
+
+      const callGraph = new CallGraphAnalyzer(functions).buildCallGraph();
+
+      expect(callGraph.calls).toHaveLength(1);
+      const call = callGraph.calls[0];
+      expect(call.calleeId).toBe('parse');
+      expect(call.calleeQualifiedName).toBe('util::parse');
+      expect(call.calleeUsr).toContain('util@F@parse');
+      expect(call.callSite.statementId).toBe('1.3');
+      expect(call.arguments.actual).toEqual(['s', '10']);
+      expect(call.arguments.types).toEqual(['std::string', 'int']);
+      expect(call.assignedTo).toBe('n');
+      expect(callGraph.callsTo.get('parse')).toHaveLength(1);
+    });
+
+    it('should resolve call sites to overloads by USR', () => {
+      const functions = new Map<string, FunctionCFG>();
+      const caller = createMockCFG('caller', ['print(3.5);']);
+      caller.blocks.get('B0')!.callSites = [{
+        callee: 'print',
+        name: 'print',
+        usr: 'c:@F@print#d#',
+        arguments: [{ text: '3.5', type: 'double', defined: [], used: [] }],
+        returnUsed: false
+      }];
+      const printInt = createMockCFG('print', ['return;']);
+      printInt.usr = 'c:@F@print#I#';
+      const printDouble = createMockCFG('print(double)', ['return;']);
+      printDouble.usr = 'c:@F@print#d#';
+      functions.set('caller', caller);
+      functions.set('print', printInt);
+      functions.set('print(double)', printDouble);
+
+      const callGraph = new CallGraphAnalyzer(functions).buildCallGraph();
+
+      expect(callGraph.calls).toHaveLength(1);
+      expect(callGraph.calls[0].calleeId).toBe('print(double)');
+    });
+
+    it('should take parameters and return type from the exported signature', () => {
+      const functions = new Map<string, FunctionCFG>();
+      const cfg = createMockCFG('copy', ['return n;']);
+      cfg.signature = {
+        returnType: 'size_t',
+        parameters: [
+          { name: 'dst', type: 'char *', canonicalType: 'char *', isReference: false, isPointer: true },
+          { name: 'n', type: 'size_t', canonicalType: 'unsigned long', isReference: false, isPointer: false }
+        ],
+        isVariadic: false
+      };
+      functions.set('copy', cfg);
+
+      const metadata = new CallGraphAnalyzer(functions).buildCallGraph().functions.get('copy')!;
+
+      expect(metadata.returnType).toBe('size_t');
+      expect(metadata.parameters).toEqual([
+        { name: 'dst', type: 'char *', position: 0 },
+        { name: 'n', type: 'unsigned long', position: 1 }
+      ]);
+    });
   });
 
   describe('Recursion detection', () => {
@@ -402,6 +402,53 @@ describe('InterProceduralReachingDefinitions - Phase 3: Inter-Procedural Data Fl
     });
   });
 
+  describe('global variables', () => {
+    it('should propagate globals written by transitive callees in one pass', () => {
+      const { callGraph, intraRD } = createTestCallGraph();
+
+      // foo() calls bar(), which writes the global 'counter'
+      const fooCFG = callGraph.functions.get('foo')!.cfg;
+      fooCFG.blocks.get('B0')!.statements.push({ id: 'stmt_2', text: 'bar();', content: 'bar();' });
+      fooCFG.globalAccess = { reads: [], writes: [] };
+      callGraph.functions.get('main')!.cfg.globalAccess = { reads: [], writes: [] };
+
+      const barCFG = createMockCFG('bar', ['counter = 1;']);
+      barCFG.variableTable = [{ id: 0, name: 'counter', kind: 'global', qualifiedName: 'counter' }];
+      barCFG.globalAccess = { reads: [], writes: ['counter'] };
+      callGraph.functions.set('bar', {
+        name: 'bar',
+        cfg: barCFG,
+        parameters: [],
+        returnType: 'void',
+        isExternal: false,
+        isRecursive: false,
+        callsCount: 1
+      });
+
+      const barCall: FunctionCall = {
+        callerId: 'foo',
+        calleeId: 'bar',
+        callSite: { blockId: 'B0', statementId: 'stmt_2', line: 2, column: 0 },
+        arguments: { actual: [], types: [] },
+        returnValueUsed: false
+      };
+      callGraph.calls.push(barCall);
+      callGraph.callsFrom.set('foo', [barCall]);
+      callGraph.callsTo.set('bar', [barCall]);
+
+      const counterDef = createDefinition('counter', 'bar_counter_B0', 'B0');
+      const barOut = new Map([['counter', [counterDef]]]);
+      intraRD.set('bar', new Map([
+        ['B0', createMockRDInfo('B0', new Map(barOut), new Map(), new Map(), barOut)]
+      ]));
+
+      const result = new InterProceduralReachingDefinitions(callGraph, intraRD).analyze();
+
+      const mainCounterDefs = result.get('main')!.get('B0')!.out.get('counter') || [];
+      expect(mainCounterDefs.map(def => def.definitionId)).toEqual(['bar_counter_B0_via_foo']);
+    });
+  });
+
   describe('fixed-point iteration', () => {
     it('should terminate within max iterations', () => {
       const { callGraph, intraRD } = createTestCallGraph();
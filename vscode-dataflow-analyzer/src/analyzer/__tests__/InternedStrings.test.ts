@@ -0,0 +1,54 @@
+/**
+ * Unit tests for InternedStrings
+ *
+ * These tests verify:
+ * 1. Interned fields resolve against the strings of earlier and current records
+ * 2. Non-interned fields and records without a table are left unchanged
+ * 3. Rejection of indices outside the table
+ */
+
+import { InternedStringTable } from '../InternedStrings';
+
+describe('InternedStringTable', () => {
+  test('resolves records against the strings added so far', () => {
+    const table = new InternedStringTable();
+    const first = table.resolveRecord({
+      file: 0,
+      function: {
+        name: 1,
+        file: 0,
+        blocks: [{ id: 2, statements: [{ id: '2.1', text: 2, defs: [0] }] }],
+        variables: [{ id: 0, name: 3, kind: 'local' }]
+      },
+      strings: ['/src/a.cpp', 'main', 'return 0;', 'x']
+    });
+    const second = table.resolveRecord({
+      file: 0,
+      function: { name: 4, file: 0, blocks: [{ id: 0, statements: [{ id: '0.1', text: 2 }] }] },
+      strings: ['helper']
+    });
+
+    expect(first).toEqual({
+      file: '/src/a.cpp',
+      function: {
+        name: 'main',
+        file: '/src/a.cpp',
+        blocks: [{ id: 2, statements: [{ id: '2.1', text: 'return 0;', defs: [0] }] }],
+        variables: [{ id: 0, name: 'x', kind: 'local' }]
+      }
+    });
+    expect(second.function.name).toBe('helper');
+    expect(second.function.blocks[0].statements[0].text).toBe('return 0;');
+  });
+
+  test('leaves plain records unchanged', () => {
+    const record = { file: '/src/a.cpp', done: true, globals: [{ name: 'g', line: 3 }] };
+    expect(new InternedStringTable().resolveRecord(record)).toEqual({
+      file: '/src/a.cpp', done: true, globals: [{ name: 'g', line: 3 }]
+    });
+  });
+
+  test('rejects indices outside the table', () => {
+    expect(() => new InternedStringTable().resolveRecord({ file: 0, strings: [] })).toThrow();
+  });
+});
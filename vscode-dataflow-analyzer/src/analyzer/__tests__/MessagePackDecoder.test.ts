@@ -0,0 +1,95 @@
+/**
+ * Unit tests for MessagePackDecoder
+ *
+ * These tests verify:
+ * 1. Decoding of the value types nlohmann::json::to_msgpack emits
+ * 2. Incremental decoding of concatenated values split at arbitrary chunk boundaries,
+ *    including inside the length fields of sized headers
+ * 3. Rejection of truncated and malformed input
+ */
+
+import { decodeMessagePack, MessagePackStreamDecoder } from '../MessagePackDecoder';
+
+/**
+ * Encoding of {"name":"main","blocks":[{"id":0,"isEntry":true,"line":-1,"size":300}],"file":null}
+ */
+const FUNCTION_RECORD = Buffer.from([
+  0x83,
+  0xa4, ...Buffer.from('name'), 0xa4, ...Buffer.from('main'),
+  0xa6, ...Buffer.from('blocks'), 0x91,
+  0x84,
+  0xa2, ...Buffer.from('id'), 0x00,
+  0xa7, ...Buffer.from('isEntry'), 0xc3,
+  0xa4, ...Buffer.from('line'), 0xff,
+  0xa4, ...Buffer.from('size'), 0xcd, 0x01, 0x2c,
+  0xa4, ...Buffer.from('file'), 0xc0
+]);
+
+const EXPECTED_RECORD = {
+  name: 'main',
+  blocks: [{ id: 0, isEntry: true, line: -1, size: 300 }],
+  file: null
+};
+
+describe('MessagePackDecoder', () => {
+  test('decodes a single function record', () => {
+    expect(decodeMessagePack(FUNCTION_RECORD)).toEqual(EXPECTED_RECORD);
+  });
+
+  test('decodes sized integers, floats and long strings', () => {
+    const longText = 'x'.repeat(40);
+    const data = Buffer.concat([
+      Buffer.from([0x95]),
+      Buffer.from([0xce, 0x00, 0x01, 0x00, 0x00]),                        // uint32 65536
+      Buffer.from([0xd1, 0xff, 0x00]),                                    // int16 -256
+      Buffer.from([0xcb, 0x3f, 0xf8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00]), // float64 1.5
+      Buffer.from([0xd9, longText.length]), Buffer.from(longText),        // str8
+      Buffer.from([0xc2])                                                 // false
+    ]);
+    expect(decodeMessagePack(data)).toEqual([65536, -256, 1.5, longText, false]);
+  });
+
+  test('streams concatenated values across chunk boundaries', () => {
+    const stream = Buffer.concat([FUNCTION_RECORD, FUNCTION_RECORD, FUNCTION_RECORD]);
+    const decoder = new MessagePackStreamDecoder();
+    const values: any[] = [];
+
+    // Feed 7-byte chunks so values are split mid-string and mid-integer
+    for (let offset = 0; offset < stream.length; offset += 7) {
+      values.push(...decoder.push(stream.subarray(offset, offset + 7)));
+    }
+
+    expect(values).toEqual([EXPECTED_RECORD, EXPECTED_RECORD, EXPECTED_RECORD]);
+    expect(decoder.pendingBytes).toBe(0);
+  });
+
+  test('finds value bounds across byte-sized chunks for every header kind', () => {
+    const value = Buffer.concat([
+      Buffer.from([0xdc, 0x00, 0x04]),                         // array16 of 4
+      Buffer.from([0xda, 0x00, 0x03]), Buffer.from('abc'),     // str16
+      Buffer.from([0xc4, 0x02, 0x01, 0x02]),                   // bin8
+      Buffer.from([0xd5, 0x07, 0xaa, 0xbb]),                   // fixext2
+      Buffer.from([0xde, 0x00, 0x01, 0xa1, 0x6b, 0x90])        // map16 {k: []}
+    ]);
+    const stream = Buffer.concat([value, value]);
+    const decoder = new MessagePackStreamDecoder();
+    const values: any[] = [];
+    for (let offset = 0; offset < stream.length; offset++) {
+      values.push(...decoder.push(stream.subarray(offset, offset + 1)));
+    }
+
+    expect(values).toEqual([decodeMessagePack(value), decodeMessagePack(value)]);
+    expect(decoder.pendingBytes).toBe(0);
+  });
+
+  test('keeps an incomplete value buffered', () => {
+    const decoder = new MessagePackStreamDecoder();
+    expect(decoder.push(FUNCTION_RECORD.subarray(0, 10))).toEqual([]);
+    expect(decoder.pendingBytes).toBe(10);
+  });
+
+  test('rejects truncated and malformed input', () => {
+    expect(() => decodeMessagePack(FUNCTION_RECORD.subarray(0, 10))).toThrow('Truncated');
+    expect(() => decodeMessagePack(Buffer.from([0xc1]))).toThrow('Invalid MessagePack type byte');
+  });
+});
@@ -0,0 +1,47 @@
+/**
+ * Unit tests for TaintRegistrySpec
+ *
+ * These tests verify:
+ * 1. Registry entries are serialized with the fields cfg-exporter reads
+ * 2. Registries with regex patterns produce no spec (text matching stays on)
+ */
+
+import { buildTaintRegistrySpec } from '../TaintRegistrySpec';
+import { TaintSourceRegistry } from '../TaintSourceRegistry';
+import { TaintSinkRegistry } from '../TaintSinkRegistry';
+import { SanitizationRegistry } from '../SanitizationRegistry';
+
+describe('TaintRegistrySpec', () => {
+  test('serializes sources, sinks and sanitizers by name', () => {
+    const sources = new TaintSourceRegistry();
+    const sinks = new TaintSinkRegistry();
+    const sanitizers = new SanitizationRegistry();
+    const spec = buildTaintRegistrySpec(sources, sinks, sanitizers)!;
+
+    expect(spec).not.toBeNull();
+    expect(spec.sources).toContainEqual({ name: 'getenv', category: 'environment', argumentIndex: -1 });
+    expect(spec.sources).toHaveLength(sources.getAllSources().length);
+    expect(spec.sinks).toHaveLength(sinks.getAllSinks().length);
+    expect(spec.sanitizers).toHaveLength(sanitizers.getAllSanitizers().length);
+
+    const systemSink = sinks.getTaintSink('system')!;
+    expect(spec.sinks.find(sink => sink.name === 'system')).toEqual({
+      name: 'system',
+      category: systemSink.category,
+      argumentIndices: systemSink.argumentIndices
+    });
+  });
+
+  test('returns null when an entry needs regex matching', () => {
+    const sources = new TaintSourceRegistry();
+    sources.addCustomSource({
+      functionName: 'readConfig',
+      category: 'configuration',
+      argumentIndex: -1,
+      taintType: 'string',
+      pattern: /read\w*Config\(/
+    });
+
+    expect(buildTaintRegistrySpec(sources, new TaintSinkRegistry(), new SanitizationRegistry())).toBeNull();
+  });
+});
@@ -146,12 +146,14 @@ export function activate(context: vscode.ExtensionContext) {
     enableTaintAnalysis: config.get('enableTaintAnalysis', true),
     debounceDelay: config.get('debounceDelay', 500),  // Milliseconds for keystroke debouncing
     enableInterProcedural: config.get('enableInterProcedural', true),
-    taintSensitivity: taintSensitivity  // Taint analysis sensitivity level (v1.9+)
+    taintSensitivity: taintSensitivity,  // Taint analysis sensitivity level (v1.9+)
+    simplifyCFG: config.get('simplifyCFG', false),
+    analyzeHeaderFunctions: config.get('analyzeHeaderFunctions', false)
   };
 
   // Initialize main analyzer with workspace path and configuration
   const analyzerInitStartTime = Date.now();
-  let analyzer = new DataflowAnalyzer(workspacePath, analysisConfig);
+  analyzer = new DataflowAnalyzer(workspacePath, analysisConfig);
   const analyzerInitTimeMs = Date.now() - analyzerInitStartTime;
   
   // Check if state was loaded and notify user
@@ -330,6 +332,7 @@ export function activate(context: vscode.ExtensionContext) {
     const stateManager = new StateManager(workspacePath);
     stateManager.clearState();
     if (analyzer) {
+      analyzer.dispose();
       analyzer = new DataflowAnalyzer(workspacePath, analysisConfig);
     }
     vscode.window.showInformationMessage('Analysis state cleared.');
@@ -588,6 +591,9 @@ export function activate(context: vscode.ExtensionContext) {
 
   context.subscriptions.push(showCFGCommand, analyzeWorkspaceCommand, analyzeActiveFileCommand, clearStateCommand, changeSensitivityAndAnalyzeCommand, saveStateCommand, reAnalyzeCommand);
 
+  // Stop the persistent cfg-exporter server when the extension is deactivated
+  context.subscriptions.push({ dispose: () => analyzer?.dispose() });
+
   // Set up file change listeners
   setupFileWatchers(context, analysisConfig);
 
@@ -629,7 +635,9 @@ export function activate(context: vscode.ExtensionContext) {
         enableTaintAnalysis: config.get('enableTaintAnalysis', true),
         debounceDelay: config.get('debounceDelay', 500),
         enableInterProcedural: config.get('enableInterProcedural', true),
-        taintSensitivity: taintSensitivity
+        taintSensitivity: taintSensitivity,
+        simplifyCFG: config.get('simplifyCFG', false),
+        analyzeHeaderFunctions: config.get('analyzeHeaderFunctions', false)
       };
       
       console.log(`[Extension] [DEBUG] Configuration changed, updating analyzer config`);
@@ -708,7 +716,8 @@ function setupFileWatchers(context: vscode.ExtensionContext, config: AnalysisCon
         debounceTimer = setTimeout(async () => {
           if (analyzer) {
             try {
-              await analyzer.updateFile(document.fileName);
+              // Analyze the editor buffer as typed; it usually differs from the saved file
+              await analyzer.updateFile(document.fileName, document.getText());
               const state = analyzer.getState();
               if (state && visualizer) {
                 // Update visualization for the changed file's panel
@@ -722,6 +731,14 @@ function setupFileWatchers(context: vscode.ExtensionContext, config: AnalysisCon
       }
     });
     context.subscriptions.push(changeWatcher);
+
+    // Release the AST and preamble the exporter keeps for each edited file
+    const closeWatcher = vscode.workspace.onDidCloseTextDocument(async (document) => {
+      if ((document.languageId === 'cpp' || document.languageId === 'c') && analyzer) {
+        await analyzer.closeFile(document.fileName);
+      }
+    });
+    context.subscriptions.push(closeWatcher);
   }
 }
 
@@ -85,7 +85,7 @@
 import * as fs from 'fs';
 import * as path from 'path';
 import * as vscode from 'vscode';
-import { AnalysisState, FileAnalysisState } from '../types';
+import { AnalysisState, FileAnalysisState, FunctionCFG } from '../types';
 import * as crypto from 'crypto';
 
 export class StateManager {
@@ -124,6 +124,13 @@ export class StateManager {
       // Reconstruct Maps from plain objects
       const deserializedState = this.deserializeState(state);
       const loadTimeMs = Date.now() - startTime;
+
+      // Reusing such functions would mix AST-derived and text-heuristic results
+      const incomplete = this.countIncompleteFunctions(deserializedState);
+      if (incomplete > 0) {
+        console.log(`[StateManager] [INFO] Discarding saved state: ${incomplete} functions lack exported call sites, signatures or variable tables`);
+        return { state: null, loadTimeMs };
+      }
       
       console.log(`[StateManager] [INFO] State loaded successfully in ${loadTimeMs}ms (${deserializedState.cfg.functions.size} functions, ${deserializedState.fileStates.size} files)`);
       return { state: deserializedState, loadTimeMs };
@@ -194,11 +201,14 @@ export class StateManager {
    * Reference: "Incremental Static Analysis" - Reps et al. (2003)
    * 
    * @param filePath - Absolute path to the file
+   * @param content - Unsaved editor contents to hash instead of reading the file
    * @returns SHA-256 hash of file content (empty string on error)
    */
-  computeFileHash(filePath: string): string {
+  computeFileHash(filePath: string, content?: string): string {
     try {
-      const content = fs.readFileSync(filePath, 'utf-8');
+      if (content === undefined) {
+        content = fs.readFileSync(filePath, 'utf-8');
+      }
       const hash = crypto.createHash('sha256').update(content).digest('hex');
       console.log(`[StateManager] [DEBUG] Computed hash for ${filePath}: ${hash.substring(0, 8)}...`);
       return hash;
@@ -208,6 +218,21 @@ export class StateManager {
     }
   }
 
+  /**
+   * Number of exporter CFGs (those with a bodyHash) saved without their
+   * variable table, which every exporter CFG has: the state predates
+   * persisting the AST-derived function and block fields.
+   */
+  private countIncompleteFunctions(state: AnalysisState): number {
+    let count = 0;
+    state.cfg.functions.forEach((funcCFG: FunctionCFG) => {
+      if (funcCFG.bodyHash && !funcCFG.variableTable) {
+        count++;
+      }
+    });
+    return count;
+  }
+
   /**
    * Serialize state for JSON storage
    */
@@ -387,10 +412,30 @@ export class StateManager {
               statements: bv.statements,
               predecessors: bv.predecessors,
               successors: bv.successors,
-              range: bv.range
+              infeasibleSuccessors: bv.infeasibleSuccessors,
+              range: bv.range,
+              isEntry: bv.isEntry,
+              isExit: bv.isExit,
+              callSites: bv.callSites,
+              terminator: bv.terminator,
+              immediateDominator: bv.immediateDominator,
+              immediatePostDominator: bv.immediatePostDominator,
+              controlDependencies: bv.controlDependencies,
+              rpo: bv.rpo,
+              postorder: bv.postorder,
+              backEdges: bv.backEdges,
+              loopHeader: bv.loopHeader,
+              loopDepth: bv.loopDepth,
+              mergedBlocks: bv.mergedBlocks
             }
           ]),
-          parameters: v.parameters
+          parameters: v.parameters,
+          usr: v.usr,
+          bodyHash: v.bodyHash,
+          variableTable: v.variableTable,
+          signature: v.signature,
+          globalAccess: v.globalAccess,
+          taintTagged: v.taintTagged
         }
       ])
     };
@@ -418,7 +463,13 @@ export class StateManager {
           entry: v.entry,
           exit: v.exit,
           blocks: funcBlocks,
-          parameters: v.parameters
+          parameters: v.parameters,
+          usr: v.usr,
+          bodyHash: v.bodyHash,
+          variableTable: v.variableTable,
+          signature: v.signature,
+          globalAccess: v.globalAccess,
+          taintTagged: v.taintTagged
         });
       });
     }
@@ -60,9 +60,84 @@ export interface BasicBlock {
   statements: Statement[];
   predecessors: string[];
   successors: string[];
+  infeasibleSuccessors?: string[];  // Edges of constant branches that are never taken (cfg-exporter)
   range?: Range;
   isEntry?: boolean;  // Optional marker for entry block
   isExit?: boolean;   // Optional marker for exit block
+  callSites?: CallSite[];  // Resolved calls evaluated in this block (cfg-exporter)
+  terminator?: BlockTerminator | null;  // null: the block falls through (cfg-exporter)
+  // Dominator trees and control dependence (cfg-exporter)
+  immediateDominator?: string;
+  immediatePostDominator?: string;
+  controlDependencies?: string[];  // Blocks whose branch decides whether this block runs
+  // Depth-first order and natural loops (cfg-exporter; unset when unreachable)
+  rpo?: number;
+  postorder?: number;
+  backEdges?: string[];  // Successors reached by a back edge
+  loopHeader?: string;   // Header of the innermost enclosing loop
+  loopDepth?: number;
+  mergedBlocks?: string[];  // Original Clang blocks of a simplified block (cfg-exporter --simplify-cfg)
+}
+
+/**
+ * How a block ends, exported by cfg-exporter from the CFG terminator
+ */
+export interface BlockTerminator {
+  kind: string;                // Clang statement class, e.g. IfStmt, WhileStmt
+  condition: {
+    text: string;
+    statementId?: string;      // Statement evaluating the condition
+    used: string[];
+    constant?: boolean;        // Value of a condition that folds to a constant
+  } | null;
+  trueSuccessor?: string;      // Two-way branches only
+  falseSuccessor?: string;
+}
+
+/**
+ * Taint role of a call site per the registry spec (cfg-exporter --taint-spec)
+ */
+export interface CallSiteTaintTag {
+  role: 'source' | 'sink' | 'sanitizer';
+  entry: string;               // Registry entry (function name) the callee matched
+  category: string;            // Source/sink category or sanitization type
+  arguments: number[];         // Tainted (source, sink) or sanitized (sanitizer) argument indices
+  target?: string;             // Variable receiving the taint or sanitized value
+}
+
+/**
+ * Call site resolved by cfg-exporter from the Clang AST
+ */
+export interface CallSite {
+  statementId?: string;        // Statement containing the call
+  callee: string | null;       // Qualified callee name, null for indirect calls
+  name: string;                // Unqualified callee name (callee expression if indirect)
+  usr?: string;                // Callee USR, distinguishes overloads
+  range?: Range;
+  arguments: {
+    text: string;
+    type: string;
+    defined: string[];
+    used: string[];
+  }[];
+  returnUsed: boolean;
+  assignedTo?: string;         // Variable receiving the return value
+  taint?: CallSiteTaintTag[];  // Set when exported with a registry spec; empty if no role
+}
+
+/**
+ * Field, element or pointee accessed through a variable (cfg-exporter)
+ */
+export interface AccessStep {
+  kind: 'field' | 'index' | 'deref';
+  name?: string;               // Field steps
+  index?: number | null;       // Index steps; null when not a constant
+}
+
+export interface AccessPath {
+  base: string;                // Variable the path is rooted at
+  steps: AccessStep[];         // In evaluation order: p->f is deref, field f
+  key: string;                 // Canonical spelling (p->f, s.buf[2], (*q)); equal paths have equal keys
 }
 
 export interface Statement {
@@ -75,6 +150,42 @@ export interface Statement {
     defined: string[];
     used: string[];
   };
+  // DEF/USE sets computed by cfg-exporter from the Clang AST, as IDs into
+  // FunctionCFG.variableTable. When present, `variables` holds the same sets by name.
+  variableIds?: {
+    defined: number[];
+    used: number[];
+  };
+  // Fields, elements and pointees written and read (cfg-exporter)
+  accessPaths?: {
+    defined: AccessPath[];
+    used: AccessPath[];
+  };
+}
+
+/**
+ * Entry of the per-function variable table emitted by cfg-exporter
+ */
+export interface ExportedVariable {
+  id: number;
+  name: string;
+  kind: 'local' | 'parameter' | 'global' | 'static';
+  qualifiedName?: string;  // Globals only
+}
+
+/**
+ * Variable with static storage duration, from the per-file table emitted by
+ * cfg-exporter
+ */
+export interface ExportedGlobal {
+  name: string;
+  qualifiedName: string;
+  usr?: string;
+  type: string;
+  kind: 'global' | 'member' | 'static';
+  isConst: boolean;
+  file?: string;
+  line?: number;
 }
 
 export enum StatementType {
@@ -100,6 +211,35 @@ export interface FunctionCFG {
   exit: string;
   blocks: Map<string, BasicBlock>;
   parameters: string[];
+  // Clang USR and hash of the exported record and the declarations the body
+  // uses (cfg-exporter); equal usr + bodyHash means the export is unchanged
+  usr?: string;
+  bodyHash?: string;
+  variableTable?: ExportedVariable[];
+  signature?: FunctionSignature;
+  // Shared globals the function reads/writes directly (cfg-exporter)
+  globalAccess?: {
+    reads: string[];
+    writes: string[];
+  };
+  // Exported with a taint registry spec: call sites carry their taint roles
+  // and untagged calls play none (cfg-exporter)
+  taintTagged?: boolean;
+}
+
+/**
+ * Function signature exported by cfg-exporter from the FunctionDecl
+ */
+export interface FunctionSignature {
+  returnType: string;
+  parameters: {
+    name: string;           // Empty for unnamed parameters
+    type: string;           // As written
+    canonicalType: string;  // Typedefs and aliases resolved
+    isReference: boolean;
+    isPointer: boolean;
+  }[];
+  isVariadic: boolean;
 }
 
 export interface LivenessInfo {
@@ -246,6 +386,8 @@ export interface AnalysisConfig {
   debounceDelay: number;
   enableInterProcedural?: boolean; // Enable IPA features (v1.2+)
   taintSensitivity?: TaintSensitivity; // Taint analysis sensitivity level (v1.9+)
+  simplifyCFG?: boolean; // Export simplified CFGs (fewer, fused blocks)
+  analyzeHeaderFunctions?: boolean; // Workspace runs: also analyze functions defined in project headers
 }
 
 export interface AnalysisState {